@@ -26,6 +26,8 @@
 
 #include "value.h"
 #include "user-regs.h"
+#include "regcache.h"
+#include "target.h"
 
 static void grow_expr (struct agent_expr *x, int n);
 
@@ -607,3 +609,244 @@ ax_reqs (struct agent_expr *ax)
 
   ax->final_height = height;
 }
+
+/* Maximum stack depth supported by ax_eval.  */
+#define AX_EVAL_STACK_MAX 100
+
+/* See ax.h.  */
+
+int
+ax_eval (struct agent_expr *ax, struct regcache *regcache,
+	 ULONGEST *result)
+{
+  struct gdbarch *gdbarch = get_regcache_arch (regcache);
+  enum bfd_endian byte_order = gdbarch_byte_order (gdbarch);
+  ULONGEST stack[AX_EVAL_STACK_MAX];
+  int sp = 0;
+  int pc = 0;
+
+  while (pc < ax->len)
+    {
+      enum agent_op op = (enum agent_op) ax->buf[pc];
+      int size;
+      int arg = 0;
+
+      if (op >= aop_last || aop_map[op].name == NULL)
+	return 1;
+
+      /* Check the operands and the stack before doing anything.  */
+      size = aop_map[op].op_size;
+      if (pc + 1 + size > ax->len)
+	return 1;
+      if (size <= 2)
+	arg = read_const (ax, pc + 1, size);
+      pc += 1 + size;
+
+      if (op != aop_pick && sp < aop_map[op].consumed)
+	return 1;
+      if (sp - aop_map[op].consumed + aop_map[op].produced
+	  > AX_EVAL_STACK_MAX)
+	return 1;
+
+      switch (op)
+	{
+	case aop_add:
+	  sp--;
+	  stack[sp - 1] += stack[sp];
+	  break;
+
+	case aop_sub:
+	  sp--;
+	  stack[sp - 1] -= stack[sp];
+	  break;
+
+	case aop_mul:
+	  sp--;
+	  stack[sp - 1] *= stack[sp];
+	  break;
+
+	case aop_div_signed:
+	case aop_div_unsigned:
+	case aop_rem_signed:
+	case aop_rem_unsigned:
+	  sp--;
+	  if (stack[sp] == 0)
+	    return 1;
+	  /* The quotient of the most negative value by -1 does not fit
+	     in a LONGEST.  */
+	  if ((op == aop_div_signed || op == aop_rem_signed)
+	      && (LONGEST) stack[sp] == -1
+	      && stack[sp - 1] == (ULONGEST) 1 << (sizeof (LONGEST) * 8 - 1))
+	    return 1;
+	  if (op == aop_div_signed)
+	    stack[sp - 1] = (LONGEST) stack[sp - 1] / (LONGEST) stack[sp];
+	  else if (op == aop_div_unsigned)
+	    stack[sp - 1] /= stack[sp];
+	  else if (op == aop_rem_signed)
+	    stack[sp - 1] = (LONGEST) stack[sp - 1] % (LONGEST) stack[sp];
+	  else
+	    stack[sp - 1] %= stack[sp];
+	  break;
+
+	case aop_lsh:
+	case aop_rsh_signed:
+	case aop_rsh_unsigned:
+	  sp--;
+	  /* Shifting by the width of the operand or more is undefined.  */
+	  if (stack[sp] >= sizeof (LONGEST) * 8)
+	    return 1;
+	  if (op == aop_lsh)
+	    stack[sp - 1] <<= stack[sp];
+	  else if (op == aop_rsh_signed)
+	    stack[sp - 1] = (LONGEST) stack[sp - 1] >> stack[sp];
+	  else
+	    stack[sp - 1] >>= stack[sp];
+	  break;
+
+	case aop_log_not:
+	  stack[sp - 1] = !stack[sp - 1];
+	  break;
+
+	case aop_bit_and:
+	  sp--;
+	  stack[sp - 1] &= stack[sp];
+	  break;
+
+	case aop_bit_or:
+	  sp--;
+	  stack[sp - 1] |= stack[sp];
+	  break;
+
+	case aop_bit_xor:
+	  sp--;
+	  stack[sp - 1] ^= stack[sp];
+	  break;
+
+	case aop_bit_not:
+	  stack[sp - 1] = ~stack[sp - 1];
+	  break;
+
+	case aop_equal:
+	  sp--;
+	  stack[sp - 1] = (stack[sp - 1] == stack[sp]);
+	  break;
+
+	case aop_less_signed:
+	  sp--;
+	  stack[sp - 1] = ((LONGEST) stack[sp - 1] < (LONGEST) stack[sp]);
+	  break;
+
+	case aop_less_unsigned:
+	  sp--;
+	  stack[sp - 1] = (stack[sp - 1] < stack[sp]);
+	  break;
+
+	case aop_ext:
+	  if (arg > 0 && arg < (int) sizeof (LONGEST) * 8)
+	    {
+	      ULONGEST mask = (ULONGEST) 1 << (arg - 1);
+
+	      stack[sp - 1] &= ((ULONGEST) 1 << arg) - 1;
+	      stack[sp - 1] = (stack[sp - 1] ^ mask) - mask;
+	    }
+	  break;
+
+	case aop_zero_ext:
+	  if (arg < (int) sizeof (LONGEST) * 8)
+	    stack[sp - 1] &= ((ULONGEST) 1 << arg) - 1;
+	  break;
+
+	case aop_ref8:
+	case aop_ref16:
+	case aop_ref32:
+	case aop_ref64:
+	  {
+	    gdb_byte buf[8];
+	    int len = aop_map[op].data_size / 8;
+
+	    if (target_read_memory ((CORE_ADDR) stack[sp - 1], buf, len) != 0)
+	      return 1;
+	    stack[sp - 1] = extract_unsigned_integer (buf, len, byte_order);
+	  }
+	  break;
+
+	case aop_if_goto:
+	  sp--;
+	  if (stack[sp])
+	    pc = arg;
+	  break;
+
+	case aop_goto:
+	  pc = arg;
+	  break;
+
+	case aop_const8:
+	case aop_const16:
+	case aop_const32:
+	case aop_const64:
+	  stack[sp++] = read_const (ax, pc - size, size);
+	  break;
+
+	case aop_reg:
+	  {
+	    ULONGEST val;
+
+	    if (arg >= gdbarch_num_regs (gdbarch))
+	      return 1;
+	    if (regcache_raw_read_unsigned (regcache, arg, &val) != REG_VALID)
+	      return 1;
+	    stack[sp++] = val;
+	  }
+	  break;
+
+	case aop_end:
+	  if (sp == 0)
+	    return 1;
+	  *result = stack[sp - 1];
+	  return 0;
+
+	case aop_dup:
+	  stack[sp] = stack[sp - 1];
+	  sp++;
+	  break;
+
+	case aop_pop:
+	  sp--;
+	  break;
+
+	case aop_pick:
+	  if (arg >= sp)
+	    return 1;
+	  stack[sp] = stack[sp - 1 - arg];
+	  sp++;
+	  break;
+
+	case aop_rot:
+	  {
+	    ULONGEST tem = stack[sp - 1];
+
+	    stack[sp - 1] = stack[sp - 2];
+	    stack[sp - 2] = stack[sp - 3];
+	    stack[sp - 3] = tem;
+	  }
+	  break;
+
+	case aop_swap:
+	  {
+	    ULONGEST tem = stack[sp - 1];
+
+	    stack[sp - 1] = stack[sp - 2];
+	    stack[sp - 2] = tem;
+	  }
+	  break;
+
+	default:
+	  /* Floating point, tracing, trace state variables and printf
+	     are not supported.  */
+	  return 1;
+	}
+    }
+
+  /* Ran off the end of the expression without an aop_end.  */
+  return 1;
+}
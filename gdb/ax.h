@@ -281,4 +281,17 @@ extern struct aop_map aop_map[];
 
 extern void ax_reqs (struct agent_expr *ax);
 
+/* Evaluate the agent expression AX against the registers in REGCACHE
+   and the memory of the current inferior, storing the value left on
+   top of the stack in *RESULT.  Only the integer subset of the
+   bytecodes used for breakpoint conditions is supported.  Return zero
+   on success, or non-zero if the expression could not be evaluated
+   (unsupported bytecode, stack overflow, unreadable memory or
+   register, division by zero or overflowing division, shift by the
+   operand width or more).  */
+
+struct regcache;
+extern int ax_eval (struct agent_expr *ax, struct regcache *regcache,
+		    ULONGEST *result);
+
 #endif /* AGENTEXPR_H */
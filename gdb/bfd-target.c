@@ -51,9 +51,7 @@ target_bfd_xfer_partial (struct target_ops *ops,
 	struct target_bfd_data *data = (struct target_bfd_data *) ops->to_data;
 	return section_table_xfer_memory_partial (readbuf, writebuf,
 						  offset, len, xfered_len,
-						  data->table.sections,
-						  data->table.sections_end,
-						  NULL);
+						  &data->table, NULL);
       }
     default:
       return TARGET_XFER_E_IO;
@@ -73,7 +71,7 @@ target_bfd_xclose (struct target_ops *t)
   struct target_bfd_data *data = (struct target_bfd_data *) t->to_data;
 
   gdb_bfd_unref (data->bfd);
-  xfree (data->table.sections);
+  clear_section_table (&data->table);
   xfree (data);
   xfree (t);
 }
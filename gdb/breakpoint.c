@@ -272,6 +272,10 @@ static void update_global_location_list (enum ugll_insert_mode);
 
 static void update_global_location_list_nothrow (enum ugll_insert_mode);
 
+static void begin_location_list_batch (void);
+
+static void end_location_list_batch (void);
+
 static int is_hardware_watchpoint (const struct breakpoint *bpt);
 
 static void insert_breakpoint_locations (void);
@@ -630,6 +634,24 @@ static CORE_ADDR bp_location_placed_address_before_address_max;
 
 static CORE_ADDR bp_location_shadow_len_after_address_max;
 
+/* The generation of the current BP_LOCATION array; see
+   bp_location->list_generation.  It is always odd, so that it never
+   matches a new location's zero generation.  */
+
+static unsigned int bp_location_generation = 1;
+
+/* While non-zero, update_global_location_list only records that
+   UGLL_MAY_INSERT updates were requested, and end_location_list_batch
+   does a single update once the outermost batch ends.  This avoids
+   rebuilding BP_LOCATION once per breakpoint when many breakpoints
+   are created or re-set in a row.  */
+
+static int location_list_batch_depth;
+
+/* Whether an update was deferred during the current batch.  */
+
+static int location_list_batch_pending;
+
 /* The locations that no longer correspond to any breakpoint, unlinked
    from bp_location array, but for which a hit may still be reported
    by a target.  */
@@ -698,6 +720,7 @@ void
 start_rbreak_breakpoints (void)
 {
   rbreak_start_breakpoint_count = breakpoint_count;
+  begin_location_list_batch ();
 }
 
 /* Called at the end of an "rbreak" command to record the last
@@ -707,6 +730,7 @@ void
 end_rbreak_breakpoints (void)
 {
   prev_breakpoint_count = rbreak_start_breakpoint_count;
+  end_location_list_batch ();
 }
 
 /* Used in run_command to zero the hit count when a new run starts.  */
@@ -12107,6 +12131,132 @@ bp_location_compare (const void *ap, const void *bp)
   return (a > b) - (a < b);
 }
 
+/* Rebuild the BP_LOCATION array from the locations of all the
+   breakpoints.  The locations that were already in the array are
+   still sorted, so only the new locations need sorting; they are then
+   merged with the others.  This keeps adding a few breakpoints to a
+   large set linear rather than O(N log N).  */
+
+static void
+build_location_list (void)
+{
+  struct bp_location **old_location = bp_location;
+  unsigned old_location_count = bp_location_count;
+  struct bp_location **added, **kept;
+  unsigned added_count = 0, kept_count = 0, i, j, k;
+  unsigned int old_gen = bp_location_generation;
+  unsigned int new_gen = old_gen + 2;
+  struct cleanup *cleanups;
+  struct breakpoint *b;
+  struct bp_location *loc;
+
+  bp_location_count = 0;
+  ALL_BREAKPOINTS (b)
+    for (loc = b->loc; loc; loc = loc->next)
+      bp_location_count++;
+
+  bp_location = XNEWVEC (struct bp_location *, bp_location_count);
+  added = XNEWVEC (struct bp_location *, bp_location_count);
+  cleanups = make_cleanup (xfree, added);
+  kept = XNEWVEC (struct bp_location *, bp_location_count);
+  make_cleanup (xfree, kept);
+
+  /* Collect the new locations, and mark the current ones that were
+     in the array already.  */
+  ALL_BREAKPOINTS (b)
+    for (loc = b->loc; loc; loc = loc->next)
+      {
+	if (loc->list_generation != old_gen)
+	  added[added_count++] = loc;
+	loc->list_generation = new_gen;
+      }
+
+  /* The locations still present, in their former order.  Locations
+     that are no longer current keep OLD_GEN.  */
+  for (i = 0; i < old_location_count; i++)
+    if (old_location[i]->list_generation == new_gen)
+      {
+	/* A location's sort key is not expected to change, but fall
+	   back to a full sort rather than rely on it.  */
+	if (kept_count > 0
+	    && bp_location_compare (&kept[kept_count - 1],
+				    &old_location[i]) > 0)
+	  break;
+	kept[kept_count++] = old_location[i];
+      }
+
+  if (i < old_location_count)
+    {
+      k = 0;
+      ALL_BREAKPOINTS (b)
+	for (loc = b->loc; loc; loc = loc->next)
+	  bp_location[k++] = loc;
+      qsort (bp_location, bp_location_count, sizeof (*bp_location),
+	     bp_location_compare);
+    }
+  else
+    {
+      gdb_assert (kept_count + added_count == bp_location_count);
+
+      qsort (added, added_count, sizeof (*added), bp_location_compare);
+
+      for (i = j = k = 0; i < kept_count || j < added_count; k++)
+	if (j == added_count
+	    || (i < kept_count
+		&& bp_location_compare (&kept[i], &added[j]) < 0))
+	  bp_location[k] = kept[i++];
+	else
+	  bp_location[k] = added[j++];
+    }
+
+  bp_location_generation = new_gen;
+  do_cleanups (cleanups);
+}
+
+/* Start deferring UGLL_MAY_INSERT updates of the global location
+   list.  Calls can nest; each must be matched by a call to
+   end_location_list_batch.  */
+
+static void
+begin_location_list_batch (void)
+{
+  location_list_batch_depth++;
+}
+
+/* End a batch started by begin_location_list_batch.  If this ends the
+   outermost batch and updates were deferred, do the update now.  This
+   is called from cleanups, so errors are printed rather than
+   thrown.  */
+
+static void
+end_location_list_batch (void)
+{
+  gdb_assert (location_list_batch_depth > 0);
+
+  if (--location_list_batch_depth == 0 && location_list_batch_pending)
+    {
+      location_list_batch_pending = 0;
+
+      TRY
+	{
+	  update_global_location_list (UGLL_MAY_INSERT);
+	}
+      CATCH (e, RETURN_MASK_ERROR)
+	{
+	  exception_print (gdb_stderr, e);
+	}
+      END_CATCH
+    }
+}
+
+/* A cleanup function that calls end_location_list_batch.  */
+
+static void
+do_end_location_list_batch (void *ignore)
+{
+  end_location_list_batch ();
+}
+
 /* Set bp_location_placed_address_before_address_max and
    bp_location_shadow_len_after_address_max according to the current
    content of the bp_location array.  */
@@ -12313,23 +12463,20 @@ update_global_location_list (enum ugll_insert_mode insert_mode)
   struct bp_location **old_location, **old_locp;
   unsigned old_location_count;
 
+  /* Defer the update if a batch is in progress.  Removals are never
+     deferred: the caller may be about to free the breakpoint that
+     owns the locations.  */
+  if (location_list_batch_depth > 0 && insert_mode == UGLL_MAY_INSERT)
+    {
+      location_list_batch_pending = 1;
+      return;
+    }
+
   old_location = bp_location;
   old_location_count = bp_location_count;
-  bp_location = NULL;
-  bp_location_count = 0;
   cleanups = make_cleanup (xfree, old_location);
 
-  ALL_BREAKPOINTS (b)
-    for (loc = b->loc; loc; loc = loc->next)
-      bp_location_count++;
-
-  bp_location = XNEWVEC (struct bp_location *, bp_location_count);
-  locp = bp_location;
-  ALL_BREAKPOINTS (b)
-    for (loc = b->loc; loc; loc = loc->next)
-      *locp++ = loc;
-  qsort (bp_location, bp_location_count, sizeof (*bp_location),
-	 bp_location_compare);
+  build_location_list ();
 
   bp_location_target_extensions_update ();
 
@@ -14435,10 +14582,16 @@ breakpoint_re_set (void)
   struct breakpoint *b, *b_tmp;
   enum language save_language;
   int save_input_radix;
-  struct cleanup *old_chain;
+  struct cleanup *old_chain, *batch_chain;
 
   save_language = current_language->la_language;
   save_input_radix = input_radix;
+
+  /* Update the global location list once, rather than once per
+     breakpoint.  */
+  begin_location_list_batch ();
+  batch_chain = make_cleanup (do_end_location_list_batch, NULL);
+
   old_chain = save_current_program_space ();
 
   ALL_BREAKPOINTS_SAFE (b, b_tmp)
@@ -14461,6 +14614,8 @@ breakpoint_re_set (void)
   create_longjmp_master_breakpoint ();
   create_std_terminate_master_breakpoint ();
   create_exception_master_breakpoint ();
+
+  do_cleanups (batch_chain);
 }
 
 /* Reset the thread number of this breakpoint:
@@ -386,6 +386,10 @@ struct bp_location
      should be downloaded and so that `tfind N' always works.  */
   char duplicate;
 
+  /* Used by update_global_location_list to tell the locations that
+     were in the global location list already from the new ones.  */
+  unsigned int list_generation;
+
   /* If we someday support real thread-specific breakpoints, then
      the breakpoint location will need a thread identifier.  */
 
@@ -34,6 +34,10 @@
 #include "rsp-low.h"
 #include "gdbcmd.h"
 #include "cli/cli-utils.h"
+#include "block.h"
+#include "minsyms.h"
+#include "objfiles.h"
+#include "symfile.h"
 
 #include <inttypes.h>
 #include <ctype.h>
@@ -50,6 +54,26 @@ static int maint_btrace_pt_skip_pad = 1;
 
 static void btrace_add_pc (struct thread_info *tp);
 
+/* The functions found for the last instruction ftrace_update_function
+   looked up, and the range of addresses for which the lookup gives the
+   same result.  Consecutive instructions are mostly in the same
+   function, so this spares most symbol lookups while computing the
+   trace.  The cache is only valid during btrace_compute_ftrace.  */
+
+struct ftrace_function_cache
+{
+  /* The range of addresses, END exclusive.  Empty if there is no
+     cached lookup.  */
+  CORE_ADDR begin;
+  CORE_ADDR end;
+
+  /* The result of the lookup.  */
+  struct minimal_symbol *mfun;
+  struct symbol *fun;
+};
+
+static struct ftrace_function_cache ftrace_function_cache;
+
 /* Print a record debug message.  Use do ... while (0) to avoid ambiguities
    when used in if statements.  */
 
@@ -458,6 +482,53 @@ ftrace_new_gap (struct btrace_function *prev, int errcode)
   return bfun;
 }
 
+/* Find the minimal symbol and the full symbol of the function containing
+   PC, and store them in *PMFUN and *PFUN.  Either may be NULL.  */
+
+static void
+ftrace_find_function (CORE_ADDR pc, struct minimal_symbol **pmfun,
+		      struct symbol **pfun)
+{
+  struct ftrace_function_cache *cache = &ftrace_function_cache;
+  struct bound_minimal_symbol bmfun;
+  struct symbol *fun;
+
+  if (cache->begin <= pc && pc < cache->end)
+    {
+      *pmfun = cache->mfun;
+      *pfun = cache->fun;
+      return;
+    }
+
+  fun = find_pc_function (pc);
+  bmfun = lookup_minimal_symbol_by_pc (pc);
+
+  *pmfun = bmfun.minsym;
+  *pfun = fun;
+
+  /* Only cache the lookup if both symbols are known, so we know where
+     they end.  Intersecting the block with the minimal symbol also
+     leaves out any other function placed within the bounds of a
+     non-contiguous function.  */
+  cache->begin = 0;
+  cache->end = 0;
+  if (fun != NULL && bmfun.minsym != NULL && !overlay_debugging)
+    {
+      const struct block *block = SYMBOL_BLOCK_VALUE (fun);
+      CORE_ADDR begin, end;
+
+      begin = max (BLOCK_START (block), BMSYMBOL_VALUE_ADDRESS (bmfun));
+      end = min (BLOCK_END (block), minimal_symbol_upper_bound (bmfun));
+      if (begin <= pc && pc < end)
+	{
+	  cache->begin = begin;
+	  cache->end = end;
+	  cache->mfun = bmfun.minsym;
+	  cache->fun = fun;
+	}
+    }
+}
+
 /* Update BFUN with respect to the instruction at PC.  This may create new
    function segments.
    Return the chronologically latest function segment, never NULL.  */
@@ -465,7 +536,6 @@ ftrace_new_gap (struct btrace_function *prev, int errcode)
 static struct btrace_function *
 ftrace_update_function (struct btrace_function *bfun, CORE_ADDR pc)
 {
-  struct bound_minimal_symbol bmfun;
   struct minimal_symbol *mfun;
   struct symbol *fun;
   struct btrace_insn *last;
@@ -473,9 +543,7 @@ ftrace_update_function (struct btrace_function *bfun, CORE_ADDR pc)
   /* Try to determine the function we're in.  We use both types of symbols
      to avoid surprises when we sometimes get a full symbol and sometimes
      only a minimal symbol.  */
-  fun = find_pc_function (pc);
-  bmfun = lookup_minimal_symbol_by_pc (pc);
-  mfun = bmfun.minsym;
+  ftrace_find_function (pc, &mfun, &fun);
 
   if (fun == NULL && mfun == NULL)
     DEBUG_FTRACE ("no symbol at %s", core_addr_to_string_nz (pc));
@@ -973,14 +1041,11 @@ btrace_compute_ftrace_pt (struct thread_info *tp,
 
 #endif /* defined (HAVE_LIBIPT)  */
 
-/* Compute the function branch trace from a block branch trace BTRACE for
-   a thread given by BTINFO.  */
+/* Helper for btrace_compute_ftrace.  */
 
 static void
-btrace_compute_ftrace (struct thread_info *tp, struct btrace_data *btrace)
+btrace_compute_ftrace_1 (struct thread_info *tp, struct btrace_data *btrace)
 {
-  DEBUG ("compute ftrace");
-
   switch (btrace->format)
     {
     case BTRACE_FORMAT_NONE:
@@ -998,6 +1063,34 @@ btrace_compute_ftrace (struct thread_info *tp, struct btrace_data *btrace)
   internal_error (__FILE__, __LINE__, _("Unkown branch trace format."));
 }
 
+/* Forget the lookups cached in ftrace_function_cache.  */
+
+static void
+ftrace_function_cache_clear (void *ignore)
+{
+  ftrace_function_cache.begin = 0;
+  ftrace_function_cache.end = 0;
+}
+
+/* Compute the function branch trace from a block branch trace BTRACE for
+   a thread given by BTINFO.  */
+
+static void
+btrace_compute_ftrace (struct thread_info *tp, struct btrace_data *btrace)
+{
+  struct cleanup *cleanup;
+
+  DEBUG ("compute ftrace");
+
+  /* Symbols may have changed since the last time.  */
+  ftrace_function_cache_clear (NULL);
+  cleanup = make_cleanup (ftrace_function_cache_clear, NULL);
+
+  btrace_compute_ftrace_1 (tp, btrace);
+
+  do_cleanups (cleanup);
+}
+
 /* Add an entry for the current PC.  */
 
 static void
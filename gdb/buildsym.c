@@ -364,7 +364,7 @@ finish_block_internal (struct symbol *symbol,
       else
 	{
 	  BLOCK_DICT (block) =
-	    dict_create_hashed (&objfile->objfile_obstack, *listhead);
+	    dict_create_probed (&objfile->objfile_obstack, *listhead);
 	}
     }
 
@@ -20,6 +20,16 @@
 #ifndef COMMON_RSP_LOW_H
 #define COMMON_RSP_LOW_H
 
+/* Once packet compression has been negotiated with the
+   QCompressPackets packet, either side may send the data of a packet
+   of at least RSP_COMPRESS_THRESHOLD bytes in compressed form: the
+   character RSP_COMPRESSED_PACKET_MARKER, the length of the
+   uncompressed data in hex, a colon, and the zlib-compressed data,
+   escaped as binary data.  */
+
+#define RSP_COMPRESSED_PACKET_MARKER '^'
+#define RSP_COMPRESS_THRESHOLD 256
+
 /* Convert hex digit A to a number, or throw an exception.  */
 
 extern int fromhex (int a);
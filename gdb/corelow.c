@@ -45,6 +45,9 @@
 #include "gdb_bfd.h"
 #include "completer.h"
 #include "filestuff.h"
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
 
 #ifndef O_LARGEFILE
 #define O_LARGEFILE 0
@@ -74,6 +77,15 @@ static struct gdbarch *core_gdbarch = NULL;
    unix child targets.  */
 static struct target_section_table *core_data;
 
+/* The core file, mapped read-only into GDB's address space, or NULL
+   if it isn't.  Memory reads are served straight from the mapping
+   when possible, instead of going through BFD's buffered file
+   I/O.  */
+static gdb_byte *core_mapping;
+
+/* The size of CORE_MAPPING.  */
+static size_t core_mapping_size;
+
 static void core_files_info (struct target_ops *);
 
 static struct core_fns *sniff_core_bfd (bfd *);
@@ -183,6 +195,103 @@ gdb_check_format (bfd *abfd)
   return (0);
 }
 
+/* Map the file of CORE_BFD into memory, for core_xfer_partial.  Not
+   being able to map it is not an error; memory is then read through
+   BFD.  */
+
+static void
+map_core_file (void)
+{
+#ifdef HAVE_MMAP
+  struct stat st;
+  void *addr;
+  int fd;
+
+  gdb_assert (core_mapping == NULL);
+
+  /* Writes go through BFD, and wouldn't necessarily be seen through
+     the mapping.  */
+  if (write_files
+      || (core_bfd->flags & BFD_IN_MEMORY) != 0
+      || core_bfd->my_archive != NULL)
+    return;
+
+  fd = gdb_open_cloexec (bfd_get_filename (core_bfd),
+			 O_RDONLY | O_BINARY | O_LARGEFILE, 0);
+  if (fd < 0)
+    return;
+
+  if (fstat (fd, &st) == 0
+      && st.st_size > 0
+      && (ULONGEST) st.st_size == (size_t) st.st_size)
+    {
+      addr = mmap (NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (addr != MAP_FAILED)
+	{
+	  core_mapping = (gdb_byte *) addr;
+	  core_mapping_size = st.st_size;
+	}
+    }
+
+  close (fd);
+#endif
+}
+
+/* Undo map_core_file.  */
+
+static void
+unmap_core_file (void)
+{
+#ifdef HAVE_MMAP
+  if (core_mapping != NULL)
+    munmap (core_mapping, core_mapping_size);
+#endif
+  core_mapping = NULL;
+  core_mapping_size = 0;
+}
+
+/* Try reading LEN bytes of core file memory at OFFSET into READBUF
+   directly from CORE_MAPPING.  Return TARGET_XFER_OK and set
+   *XFERED_LEN on success.  Return TARGET_XFER_E_IO if the read has
+   to go through BFD instead.  */
+
+static enum target_xfer_status
+core_xfer_mapped_memory (gdb_byte *readbuf, ULONGEST offset, ULONGEST len,
+			 ULONGEST *xfered_len)
+{
+  struct target_section *p;
+  asection *asect;
+  ULONGEST sec_offset;
+  ULONGEST file_offset;
+
+  p = section_table_find (core_data, offset, NULL);
+  if (p == NULL)
+    return TARGET_XFER_E_IO;
+
+  /* Sections without contents read as zeros, and sections BFD
+     synthesized have no file position; leave those to BFD.  */
+  asect = p->the_bfd_section;
+  if ((bfd_get_section_flags (core_bfd, asect) & SEC_HAS_CONTENTS) == 0
+      || (bfd_get_section_flags (core_bfd, asect) & SEC_IN_MEMORY) != 0
+      || asect->owner != core_bfd
+      || asect->filepos < 0)
+    return TARGET_XFER_E_IO;
+
+  if (len > p->endaddr - offset)
+    len = p->endaddr - offset;
+  sec_offset = offset - p->addr;
+  file_offset = asect->filepos + sec_offset;
+
+  /* The core file may be truncated.  */
+  if (file_offset > core_mapping_size
+      || len > core_mapping_size - file_offset)
+    return TARGET_XFER_E_IO;
+
+  memcpy (readbuf, core_mapping + file_offset, len);
+  *xfered_len = len;
+  return TARGET_XFER_OK;
+}
+
 /* Discard all vestiges of any previous core file and mark data and
    stack spaces as empty.  */
 
@@ -203,11 +312,13 @@ core_close (struct target_ops *self)
 
       if (core_data)
 	{
-	  xfree (core_data->sections);
+	  clear_section_table (core_data);
 	  xfree (core_data);
 	  core_data = NULL;
 	}
 
+      unmap_core_file ();
+
       gdb_bfd_unref (core_bfd);
       core_bfd = NULL;
     }
@@ -352,6 +463,8 @@ core_open (const char *arg, int from_tty)
     error (_("\"%s\": Can't find sections: %s"),
 	   bfd_get_filename (core_bfd), bfd_errmsg (bfd_get_error ()));
 
+  map_core_file ();
+
   /* If we have no exec file, try to set the architecture from the
      core file.  We don't do this unconditionally since an exec file
      typically contains more information that helps us determine the
@@ -712,11 +825,13 @@ core_xfer_partial (struct target_ops *ops, enum target_object object,
   switch (object)
     {
     case TARGET_OBJECT_MEMORY:
+      if (readbuf != NULL && core_mapping != NULL
+	  && core_xfer_mapped_memory (readbuf, offset, len,
+				      xfered_len) == TARGET_XFER_OK)
+	return TARGET_XFER_OK;
       return section_table_xfer_memory_partial (readbuf, writebuf,
 						offset, len, xfered_len,
-						core_data->sections,
-						core_data->sections_end,
-						NULL);
+						core_data, NULL);
 
     case TARGET_OBJECT_AUXV:
       if (readbuf)
@@ -23,7 +23,7 @@
 #include "gdbcore.h"
 #include "target-dcache.h"
 #include "inferior.h"
-#include "splay-tree.h"
+#include "hashtab.h"
 
 /* Commands with a prefix of `{set,show} dcache'.  */
 static struct cmd_list_element *dcache_set_list = NULL;
@@ -42,14 +42,20 @@ static struct cmd_list_element *dcache_show_list = NULL;
    significantly.  This is most useful when accessing a large amount
    of data, such as when performing a backtrace.
 
-   The cache is a splay tree along with a linked list for replacement.
-   Each block caches a LINE_SIZE area of memory.  Within each line we
-   remember the address of the line (which must be a multiple of
-   LINE_SIZE) and the actual data block.
+   The cache is a hash table keyed by line address along with a linked
+   list for replacement.  Each block caches a LINE_SIZE area of memory.
+   Within each line we remember the address of the line (which must be
+   a multiple of LINE_SIZE) and the actual data block.
 
    Lines are only allocated as needed, so DCACHE_SIZE really specifies the
    *maximum* number of lines in the cache.
 
+   When misses hit consecutive lines, the cache assumes the caller is
+   scanning memory sequentially and fetches the following lines in the
+   same target request.  The read-ahead window doubles with each
+   sequential miss, up to DCACHE_READAHEAD lines, and drops back to a
+   single line as soon as the access pattern stops being sequential.
+
    At present, the cache is write-through rather than writeback: as soon
    as data is written to the cache, it is also immediately written to
    the target.  Therefore, cache lines are never "dirty".  Whether a given
@@ -82,6 +88,12 @@ static unsigned dcache_size = DCACHE_DEFAULT_SIZE;
 #define DCACHE_DEFAULT_LINE_SIZE 64
 static unsigned dcache_line_size = DCACHE_DEFAULT_LINE_SIZE;
 
+/* The maximum number of lines fetched by a single target request when
+   the cache detects sequential access.  Zero or one disables
+   read-ahead.  */
+#define DCACHE_DEFAULT_READAHEAD 16
+static unsigned dcache_readahead = DCACHE_DEFAULT_READAHEAD;
+
 /* Each cache block holds LINE_SIZE bytes of data
    starting at a multiple-of-LINE_SIZE address.  */
 
@@ -102,7 +114,8 @@ struct dcache_block
 
 struct dcache_struct
 {
-  splay_tree tree;
+  /* Hash table of the valid blocks, keyed by line address.  */
+  htab_t lines;
   struct dcache_block *oldest; /* least-recently-allocated list.  */
 
   /* The free list is maintained identically to OLDEST to simplify
@@ -115,6 +128,22 @@ struct dcache_struct
 
   /* The ptid of last inferior to use cache or null_ptid.  */
   ptid_t ptid;
+
+  /* The line address following the lines filled by the last miss.  A
+     miss at this address means memory is being scanned sequentially.  */
+  CORE_ADDR next_miss;
+
+  /* The number of lines the next sequential miss will fetch.  */
+  unsigned readahead;
+
+  /* Scratch buffer for read-ahead requests, and its size.  */
+  gdb_byte *buffer;
+  size_t buffer_size;
+
+  /* Statistics shown by "info dcache".  */
+  ULONGEST hits;
+  ULONGEST misses;
+  ULONGEST readahead_lines;
 };
 
 typedef void (block_func) (struct dcache_block *block, void *param);
@@ -127,6 +156,8 @@ static struct dcache_block *dcache_alloc (DCACHE *dcache, CORE_ADDR addr);
 
 static void dcache_info (char *exp, int tty);
 
+static void dcache_invalidate_line (DCACHE *dcache, CORE_ADDR addr);
+
 void _initialize_dcache (void);
 
 static int dcache_enabled_p = 0; /* OBSOLETE */
@@ -209,6 +240,56 @@ for_each_block (struct dcache_block **blist, block_func *func, void *param)
   while (*blist && db != *blist);
 }
 
+/* Hash a line address.  The low bits of a line address are always
+   zero, so fold the higher ones in.  */
+
+static hashval_t
+dcache_hash_addr (CORE_ADDR addr)
+{
+  return (hashval_t) (addr ^ (addr >> 16));
+}
+
+/* Hash function for the LINES table.  */
+
+static hashval_t
+hash_dcache_block (const void *p)
+{
+  const struct dcache_block *db = (const struct dcache_block *) p;
+
+  return dcache_hash_addr (db->addr);
+}
+
+/* Equality function for the LINES table.  Lookups are done with a
+   pointer to the line address as the key.  */
+
+static int
+eq_dcache_block (const void *a, const void *b)
+{
+  const struct dcache_block *db = (const struct dcache_block *) a;
+  const CORE_ADDR *addr = (const CORE_ADDR *) b;
+
+  return db->addr == *addr;
+}
+
+/* Return the block caching line address LINE, or NULL.  This does not
+   count as a hit.  */
+
+static struct dcache_block *
+dcache_lookup (DCACHE *dcache, CORE_ADDR line)
+{
+  return ((struct dcache_block *)
+	  htab_find_with_hash (dcache->lines, &line, dcache_hash_addr (line)));
+}
+
+/* Remove block DB from the LINES table.  */
+
+static void
+dcache_unlink (DCACHE *dcache, struct dcache_block *db)
+{
+  htab_remove_elt_with_hash (dcache->lines, &db->addr,
+			     dcache_hash_addr (db->addr));
+}
+
 /* BLOCK_FUNC routine for dcache_free.  */
 
 static void
@@ -222,23 +303,24 @@ free_block (struct dcache_block *block, void *param)
 void
 dcache_free (DCACHE *dcache)
 {
-  splay_tree_delete (dcache->tree);
+  htab_delete (dcache->lines);
   for_each_block (&dcache->oldest, free_block, NULL);
   for_each_block (&dcache->freelist, free_block, NULL);
+  xfree (dcache->buffer);
   xfree (dcache);
 }
 
 
 /* BLOCK_FUNC function for dcache_invalidate.
    This doesn't remove the block from the oldest list on purpose.
-   dcache_invalidate will do it later.  */
+   dcache_invalidate will do it later.  The LINES table is emptied
+   in one go by the caller.  */
 
 static void
 invalidate_block (struct dcache_block *block, void *param)
 {
   DCACHE *dcache = (DCACHE *) param;
 
-  splay_tree_remove (dcache->tree, (splay_tree_key) block->addr);
   append_block (&dcache->freelist, block);
 }
 
@@ -248,10 +330,13 @@ void
 dcache_invalidate (DCACHE *dcache)
 {
   for_each_block (&dcache->oldest, invalidate_block, dcache);
+  htab_empty (dcache->lines);
 
   dcache->oldest = NULL;
   dcache->size = 0;
   dcache->ptid = null_ptid;
+  dcache->next_miss = 0;
+  dcache->readahead = 1;
 
   if (dcache->line_size != dcache_line_size)
     {
@@ -269,11 +354,11 @@ dcache_invalidate (DCACHE *dcache)
 static void
 dcache_invalidate_line (DCACHE *dcache, CORE_ADDR addr)
 {
-  struct dcache_block *db = dcache_hit (dcache, addr);
+  struct dcache_block *db = dcache_lookup (dcache, MASK (dcache, addr));
 
   if (db)
     {
-      splay_tree_remove (dcache->tree, (splay_tree_key) db->addr);
+      dcache_unlink (dcache, db);
       remove_block (&dcache->oldest, db);
       append_block (&dcache->freelist, db);
       --dcache->size;
@@ -286,37 +371,27 @@ dcache_invalidate_line (DCACHE *dcache, CORE_ADDR addr)
 static struct dcache_block *
 dcache_hit (DCACHE *dcache, CORE_ADDR addr)
 {
-  struct dcache_block *db;
-
-  splay_tree_node node = splay_tree_lookup (dcache->tree,
-					    (splay_tree_key) MASK (dcache, addr));
+  struct dcache_block *db = dcache_lookup (dcache, MASK (dcache, addr));
 
-  if (!node)
+  if (!db)
     return NULL;
 
-  db = (struct dcache_block *) node->value;
   db->refs++;
+  dcache->hits++;
   return db;
 }
 
-/* Fill a cache line from target memory.
-   The result is 1 for success, 0 if the (entire) cache line
-   wasn't readable.  */
+/* Read LEN bytes of target memory at MEMADDR into MYADDR, skipping
+   write-only memory regions.  The result is 1 for success, 0 if the
+   range wasn't entirely readable.  */
 
 static int
-dcache_read_line (DCACHE *dcache, struct dcache_block *db)
+dcache_read_range (CORE_ADDR memaddr, gdb_byte *myaddr, ULONGEST len)
 {
-  CORE_ADDR memaddr;
-  gdb_byte *myaddr;
-  int len;
+  ULONGEST reg_len;
   int res;
-  int reg_len;
   struct mem_region *region;
 
-  len = dcache->line_size;
-  memaddr = db->addr;
-  myaddr  = db->data;
-
   while (len > 0)
     {
       /* Don't overrun if this block is right at the end of the region.  */
@@ -348,6 +423,16 @@ dcache_read_line (DCACHE *dcache, struct dcache_block *db)
   return 1;
 }
 
+/* Fill a cache line from target memory.
+   The result is 1 for success, 0 if the (entire) cache line
+   wasn't readable.  */
+
+static int
+dcache_read_line (DCACHE *dcache, struct dcache_block *db)
+{
+  return dcache_read_range (db->addr, db->data, dcache->line_size);
+}
+
 /* Get a free cache block, put or keep it on the valid list,
    and return its address.  */
 
@@ -362,7 +447,7 @@ dcache_alloc (DCACHE *dcache, CORE_ADDR addr)
       db = dcache->oldest;
       remove_block (&dcache->oldest, db);
 
-      splay_tree_remove (dcache->tree, (splay_tree_key) db->addr);
+      dcache_unlink (dcache, db);
     }
   else
     {
@@ -383,61 +468,102 @@ dcache_alloc (DCACHE *dcache, CORE_ADDR addr)
   /* Put DB at the end of the list, it's the newest.  */
   append_block (&dcache->oldest, db);
 
-  splay_tree_insert (dcache->tree, (splay_tree_key) db->addr,
-		     (splay_tree_value) db);
+  *htab_find_slot_with_hash (dcache->lines, &db->addr,
+			     dcache_hash_addr (db->addr), INSERT) = db;
 
   return db;
 }
 
-/* Using the data cache DCACHE, store in *PTR the contents of the byte at
-   address ADDR in the remote machine.  
+/* Return the number of lines to fetch for a miss on line LINE, and
+   update the read-ahead state.  The window only grows while misses
+   are sequential, never crosses the end of the memory region
+   containing LINE, and stops at the first line that is already
+   cached.  */
 
-   Returns 1 for success, 0 for error.  */
-
-static int
-dcache_peek_byte (DCACHE *dcache, CORE_ADDR addr, gdb_byte *ptr)
+static unsigned
+dcache_readahead_count (DCACHE *dcache, CORE_ADDR line)
 {
-  struct dcache_block *db = dcache_hit (dcache, addr);
+  struct mem_region *region;
+  unsigned max, count;
 
-  if (!db)
+  max = dcache_readahead;
+  /* Don't let read-ahead evict lines it has just fetched.  */
+  if (max > dcache_size / 2)
+    max = dcache_size / 2;
+
+  if (line != dcache->next_miss || max <= 1)
+    dcache->readahead = 1;
+  else if (dcache->readahead < max)
+    dcache->readahead = (dcache->readahead * 2 < max
+			 ? dcache->readahead * 2 : max);
+
+  region = lookup_mem_region (line);
+  for (count = 1; count < dcache->readahead; count++)
     {
-      db = dcache_alloc (dcache, addr);
+      CORE_ADDR next = line + count * dcache->line_size;
 
-      if (!dcache_read_line (dcache, db))
-         return 0;
+      if (next < line
+	  || (region->hi != 0 && next >= region->hi)
+	  || dcache_lookup (dcache, next) != NULL)
+	break;
     }
 
-  *ptr = db->data[XFORM (dcache, addr)];
-  return 1;
+  return count;
 }
 
-/* Write the byte at PTR into ADDR in the data cache.
+/* Fill the line containing ADDR, and possibly the lines following it,
+   from target memory.  Return the block for ADDR, or NULL if its line
+   could not be read.  */
+
+static struct dcache_block *
+dcache_fill (DCACHE *dcache, CORE_ADDR addr)
+{
+  CORE_ADDR line = MASK (dcache, addr);
+  struct dcache_block *db;
+  unsigned count, i;
+  size_t len;
+
+  dcache->misses++;
+  count = dcache_readahead_count (dcache, line);
 
-   The caller should have written the data through to target memory
-   already.
+  if (count > 1)
+    {
+      len = (size_t) count * dcache->line_size;
+      if (dcache->buffer_size < len)
+	{
+	  dcache->buffer = (gdb_byte *) xrealloc (dcache->buffer, len);
+	  dcache->buffer_size = len;
+	}
 
-   If ADDR is not in cache, this function does nothing; writing to an
-   area of memory which wasn't present in the cache doesn't cause it
-   to be loaded in.  */
+      /* Read-ahead is speculative; if the whole range can't be read,
+	 fall back to reading just the line the caller asked for.  */
+      if (dcache_read_range (line, dcache->buffer, len))
+	{
+	  for (i = count; i > 0; i--)
+	    {
+	      db = dcache_alloc (dcache, line + (i - 1) * dcache->line_size);
+	      memcpy (db->data, dcache->buffer + (i - 1) * dcache->line_size,
+		      dcache->line_size);
+	    }
+
+	  dcache->readahead_lines += count - 1;
+	  dcache->next_miss = line + len;
+	  return db;
+	}
 
-static void
-dcache_poke_byte (DCACHE *dcache, CORE_ADDR addr, const gdb_byte *ptr)
-{
-  struct dcache_block *db = dcache_hit (dcache, addr);
+      dcache->readahead = 1;
+    }
 
-  if (db)
-    db->data[XFORM (dcache, addr)] = *ptr;
-}
+  db = dcache_alloc (dcache, line);
+  if (!dcache_read_line (dcache, db))
+    {
+      /* Discard the line so we don't have a partially read line.  */
+      dcache_invalidate_line (dcache, line);
+      return NULL;
+    }
 
-static int
-dcache_splay_tree_compare (splay_tree_key a, splay_tree_key b)
-{
-  if (a > b)
-    return 1;
-  else if (a == b)
-    return 0;
-  else
-    return -1;
+  dcache->next_miss = line + dcache->line_size;
+  return db;
 }
 
 /* Allocate and initialize a data cache.  */
@@ -447,15 +573,21 @@ dcache_init (void)
 {
   DCACHE *dcache = XNEW (DCACHE);
 
-  dcache->tree = splay_tree_new (dcache_splay_tree_compare,
-				 NULL,
-				 NULL);
+  dcache->lines = htab_create_alloc (64, hash_dcache_block, eq_dcache_block,
+				     NULL, xcalloc, xfree);
 
   dcache->oldest = NULL;
   dcache->freelist = NULL;
   dcache->size = 0;
   dcache->line_size = dcache_line_size;
   dcache->ptid = null_ptid;
+  dcache->next_miss = 0;
+  dcache->readahead = 1;
+  dcache->buffer = NULL;
+  dcache->buffer_size = 0;
+  dcache->hits = 0;
+  dcache->misses = 0;
+  dcache->readahead_lines = 0;
 
   return dcache;
 }
@@ -482,15 +614,29 @@ dcache_read_memory_partial (struct target_ops *ops, DCACHE *dcache,
       dcache->ptid = inferior_ptid;
     }
 
-  for (i = 0; i < len; i++)
+  /* Copy a line at a time; only the first access to each line needs
+     a lookup.  */
+  i = 0;
+  while (i < len)
     {
-      if (!dcache_peek_byte (dcache, memaddr + i, myaddr + i))
+      CORE_ADDR addr = memaddr + i;
+      struct dcache_block *db = dcache_hit (dcache, addr);
+      ULONGEST offset = XFORM (dcache, addr);
+      ULONGEST chunk = dcache->line_size - offset;
+
+      if (db == NULL)
 	{
-	  /* That failed.  Discard its cache line so we don't have a
+	  /* If that fails, dcache_fill has already discarded the
 	     partially read line.  */
-	  dcache_invalidate_line (dcache, memaddr + i);
-	  break;
+	  db = dcache_fill (dcache, addr);
+	  if (db == NULL)
+	    break;
 	}
+
+      if (chunk > len - i)
+	chunk = len - i;
+      memcpy (myaddr + i, db->data + offset, chunk);
+      i += chunk;
     }
 
   if (i == 0)
@@ -525,17 +671,74 @@ dcache_update (DCACHE *dcache, enum target_xfer_status status,
 	       CORE_ADDR memaddr, const gdb_byte *myaddr,
 	       ULONGEST len)
 {
-  ULONGEST i;
+  ULONGEST i = 0;
+
+  /* Writing to an area of memory which wasn't present in the cache
+     doesn't cause it to be loaded in.  */
+  while (i < len)
+    {
+      CORE_ADDR addr = memaddr + i;
+      ULONGEST offset = XFORM (dcache, addr);
+      ULONGEST chunk = dcache->line_size - offset;
+
+      if (chunk > len - i)
+	chunk = len - i;
+
+      if (status == TARGET_XFER_OK)
+	{
+	  struct dcache_block *db
+	    = dcache_lookup (dcache, MASK (dcache, addr));
+
+	  if (db)
+	    memcpy (db->data + offset, myaddr + i, chunk);
+	}
+      else
+	{
+	  /* Discard the whole cache line so we don't have a partially
+	     valid line.  */
+	  dcache_invalidate_line (dcache, addr);
+	}
+
+      i += chunk;
+    }
+}
+
+/* qsort comparison function for dcache_sorted_lines.  */
+
+static int
+compare_dcache_blocks (const void *a, const void *b)
+{
+  const struct dcache_block *da = *(const struct dcache_block **) a;
+  const struct dcache_block *db = *(const struct dcache_block **) b;
+
+  if (da->addr < db->addr)
+    return -1;
+  return da->addr > db->addr;
+}
+
+/* Return a newly allocated array of the valid lines in DCACHE, sorted
+   by address.  The number of lines is DCACHE->size.  */
+
+static struct dcache_block **
+dcache_sorted_lines (DCACHE *dcache)
+{
+  struct dcache_block **lines;
+  struct dcache_block *db;
+  int i = 0;
 
-  for (i = 0; i < len; i++)
-    if (status == TARGET_XFER_OK)
-      dcache_poke_byte (dcache, memaddr + i, myaddr + i);
-    else
+  lines = XNEWVEC (struct dcache_block *, dcache->size + 1);
+  db = dcache->oldest;
+  if (db != NULL)
+    do
       {
-	/* Discard the whole cache line so we don't have a partially
-	   valid line.  */
-	dcache_invalidate_line (dcache, memaddr + i);
+	lines[i++] = db;
+	db = db->next;
       }
+    while (db != dcache->oldest);
+  gdb_assert (i == dcache->size);
+
+  qsort (lines, dcache->size, sizeof (*lines), compare_dcache_blocks);
+  return lines;
 }
 
 /* Print DCACHE line INDEX.  */
@@ -543,9 +746,9 @@ dcache_update (DCACHE *dcache, enum target_xfer_status status,
 static void
 dcache_print_line (DCACHE *dcache, int index)
 {
-  splay_tree_node n;
+  struct dcache_block **lines;
   struct dcache_block *db;
-  int i, j;
+  int j;
 
   if (dcache == NULL)
     {
@@ -553,22 +756,15 @@ dcache_print_line (DCACHE *dcache, int index)
       return;
     }
 
-  n = splay_tree_min (dcache->tree);
-
-  for (i = index; i > 0; --i)
-    {
-      if (!n)
-	break;
-      n = splay_tree_successor (dcache->tree, n->key);
-    }
-
-  if (!n)
+  if (index >= dcache->size)
     {
       printf_filtered (_("No such cache line exists.\n"));
       return;
     }
-    
-  db = (struct dcache_block *) n->value;
+
+  lines = dcache_sorted_lines (dcache);
+  db = lines[index];
+  xfree (lines);
 
   printf_filtered (_("Line %d: address %s [%d hits]\n"),
 		   index, paddress (target_gdbarch (), db->addr), db->refs);
@@ -589,7 +785,7 @@ dcache_print_line (DCACHE *dcache, int index)
 static void
 dcache_info_1 (DCACHE *dcache, char *exp)
 {
-  splay_tree_node n;
+  struct dcache_block **lines;
   int i, refcount;
 
   if (exp)
@@ -623,22 +819,24 @@ dcache_info_1 (DCACHE *dcache, char *exp)
 
   refcount = 0;
 
-  n = splay_tree_min (dcache->tree);
-  i = 0;
+  lines = dcache_sorted_lines (dcache);
 
-  while (n)
+  for (i = 0; i < dcache->size; i++)
     {
-      struct dcache_block *db = (struct dcache_block *) n->value;
+      struct dcache_block *db = lines[i];
 
       printf_filtered (_("Line %d: address %s [%d hits]\n"),
 		       i, paddress (target_gdbarch (), db->addr), db->refs);
-      i++;
       refcount += db->refs;
-
-      n = splay_tree_successor (dcache->tree, n->key);
     }
 
+  xfree (lines);
+
   printf_filtered (_("Cache state: %d active lines, %d hits\n"), i, refcount);
+  printf_filtered (_("Cache statistics: %s hits, %s misses, "
+		     "%s lines read ahead\n"),
+		   pulongest (dcache->hits), pulongest (dcache->misses),
+		   pulongest (dcache->readahead_lines));
 }
 
 static void
@@ -724,6 +922,17 @@ Show dcache line size."),
 			     set_dcache_line_size,
 			     NULL,
 			     &dcache_set_list, &dcache_show_list);
+  add_setshow_zuinteger_cmd ("read-ahead", class_obscure,
+			     &dcache_readahead, _("\
+Set maximum number of dcache lines read ahead in one request."), _("\
+Show maximum number of dcache lines read ahead in one request."), _("\
+When consecutive cache lines are missed, the dcache fetches the\n\
+following lines in the same target request, doubling the number of\n\
+lines each time the pattern repeats up to this limit.\n\
+A value of 0 or 1 disables read-ahead."),
+			     NULL,
+			     NULL,
+			     &dcache_set_list, &dcache_show_list);
   add_setshow_zuinteger_cmd ("size", class_obscure,
 			     &dcache_size, _("\
 Set number of dcache lines."), _("\
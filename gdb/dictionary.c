@@ -88,10 +88,11 @@
 
 enum dict_type
   {
-    /* Symbols are stored in a fixed-size hash table.  */
-    DICT_HASHED,
     /* Symbols are stored in an expandable hash table.  */
     DICT_HASHED_EXPANDABLE,
+    /* Symbols are stored in a fixed-size open-addressed hash table,
+       along with their hashes.  */
+    DICT_PROBED,
     /* Symbols are stored in a fixed-size array.  */
     DICT_LINEAR,
     /* Symbols are stored in an expandable array.  */
@@ -130,12 +131,6 @@ struct dict_vector
    the common data at the top of their structs, ordered in the same
    way.  */
 
-struct dictionary_hashed
-{
-  int nbuckets;
-  struct symbol **buckets;
-};
-
 struct dictionary_hashed_expandable
 {
   /* How many buckets we currently have.  */
@@ -146,6 +141,18 @@ struct dictionary_hashed_expandable
   int nsyms;
 };
 
+struct dictionary_probed
+{
+  /* The number of slots; always a power of 2, and greater than the
+     number of symbols.  */
+  int nslots;
+  /* The hash of the symbol in each slot, as computed by probed_hash,
+     or 0 for an empty slot.  Keeping these apart from the symbols
+     means a probe only touches the symbols whose hash matches.  */
+  unsigned int *hashes;
+  struct symbol **syms;
+};
+
 struct dictionary_linear
 {
   int nsyms;
@@ -168,8 +175,8 @@ struct dictionary
   const struct dict_vector *vector;
   union
   {
-    struct dictionary_hashed hashed;
     struct dictionary_hashed_expandable hashed_expandable;
+    struct dictionary_probed probed;
     struct dictionary_linear linear;
     struct dictionary_linear_expandable linear_expandable;
   }
@@ -180,14 +187,16 @@ struct dictionary
 
 #define DICT_VECTOR(d)			(d)->vector
 
-/* These can be used for DICT_HASHED_EXPANDABLE, too.  */
-
-#define DICT_HASHED_NBUCKETS(d)		(d)->data.hashed.nbuckets
-#define DICT_HASHED_BUCKETS(d)		(d)->data.hashed.buckets
+#define DICT_HASHED_NBUCKETS(d)		(d)->data.hashed_expandable.nbuckets
+#define DICT_HASHED_BUCKETS(d)		(d)->data.hashed_expandable.buckets
 #define DICT_HASHED_BUCKET(d,i)		DICT_HASHED_BUCKETS (d) [i]
 
 #define DICT_HASHED_EXPANDABLE_NSYMS(d)	(d)->data.hashed_expandable.nsyms
 
+#define DICT_PROBED_NSLOTS(d)		(d)->data.probed.nslots
+#define DICT_PROBED_HASHES(d)		(d)->data.probed.hashes
+#define DICT_PROBED_SYMS(d)		(d)->data.probed.syms
+
 /* These can be used for DICT_LINEAR_EXPANDABLEs, too.  */
 
 #define DICT_LINEAR_NSYMS(d)		(d)->data.linear.nsyms
@@ -206,6 +215,11 @@ struct dictionary
 
 #define DICT_HASHTABLE_SIZE(n)	((n)/5 + 1)
 
+/* The minimum number of slots of a DICT_PROBED dictionary holding N
+   symbols.  This keeps the load factor at most 2/3.  */
+
+#define DICT_PROBED_MIN_SLOTS(n)	((n) + (n) / 2 + 1)
+
 /* Accessor macros for dict_iterators; they're here rather than
    dictionary.h because code elsewhere should treat dict_iterators as
    opaque.  */
@@ -213,7 +227,8 @@ struct dictionary
 /* The dictionary that the iterator is associated to.  */
 #define DICT_ITERATOR_DICT(iter)		(iter)->dict
 /* For linear dictionaries, the index of the last symbol returned; for
-   hashed dictionaries, the bucket of the last symbol returned.  */
+   hashed dictionaries, the bucket of the last symbol returned; for
+   probed dictionaries, the slot of the last symbol returned.  */
 #define DICT_ITERATOR_INDEX(iter)		(iter)->index
 /* For hashed dictionaries, this points to the last symbol returned;
    otherwise, this is unused.  */
@@ -228,8 +243,7 @@ static void add_symbol_nonexpandable (struct dictionary *dict,
 
 static void free_obstack (struct dictionary *dict);
 
-/* Functions for DICT_HASHED and DICT_HASHED_EXPANDABLE
-   dictionaries.  */
+/* Functions for DICT_HASHED_EXPANDABLE dictionaries.  */
 
 static struct symbol *iterator_first_hashed (const struct dictionary *dict,
 					     struct dict_iterator *iterator);
@@ -247,12 +261,6 @@ static struct symbol *iter_match_next_hashed (const char *name,
 
 static unsigned int dict_hash (const char *string);
 
-/* Functions only for DICT_HASHED.  */
-
-static int size_hashed (const struct dictionary *dict);
-
-/* Functions only for DICT_HASHED_EXPANDABLE.  */
-
 static void free_hashed_expandable (struct dictionary *dict);
 
 static void add_symbol_hashed_expandable (struct dictionary *dict,
@@ -260,6 +268,24 @@ static void add_symbol_hashed_expandable (struct dictionary *dict,
 
 static int size_hashed_expandable (const struct dictionary *dict);
 
+/* Functions for DICT_PROBED.  */
+
+static struct symbol *iterator_first_probed (const struct dictionary *dict,
+					     struct dict_iterator *iterator);
+
+static struct symbol *iterator_next_probed (struct dict_iterator *iterator);
+
+static struct symbol *iter_match_first_probed (const struct dictionary *dict,
+					       const char *name,
+					       symbol_compare_ftype *compare,
+					       struct dict_iterator *iterator);
+
+static struct symbol *iter_match_next_probed (const char *name,
+					      symbol_compare_ftype *compare,
+					      struct dict_iterator *iterator);
+
+static int size_probed (const struct dictionary *dict);
+
 /* Functions for DICT_LINEAR and DICT_LINEAR_EXPANDABLE
    dictionaries.  */
 
@@ -288,18 +314,6 @@ static void add_symbol_linear_expandable (struct dictionary *dict,
 
 /* Various vectors that we'll actually use.  */
 
-static const struct dict_vector dict_hashed_vector =
-  {
-    DICT_HASHED,			/* type */
-    free_obstack,			/* free */
-    add_symbol_nonexpandable,		/* add_symbol */
-    iterator_first_hashed,		/* iterator_first */
-    iterator_next_hashed,		/* iterator_next */
-    iter_match_first_hashed,		/* iter_name_first */
-    iter_match_next_hashed,		/* iter_name_next */
-    size_hashed,			/* size */
-  };
-
 static const struct dict_vector dict_hashed_expandable_vector =
   {
     DICT_HASHED_EXPANDABLE,		/* type */
@@ -312,6 +326,18 @@ static const struct dict_vector dict_hashed_expandable_vector =
     size_hashed_expandable,		/* size */
   };
 
+static const struct dict_vector dict_probed_vector =
+  {
+    DICT_PROBED,			/* type */
+    free_obstack,			/* free */
+    add_symbol_nonexpandable,		/* add_symbol */
+    iterator_first_probed,		/* iterator_first */
+    iterator_next_probed,		/* iterator_next */
+    iter_match_first_probed,		/* iter_name_first */
+    iter_match_next_probed,		/* iter_name_next */
+    size_probed,			/* size */
+  };
+
 static const struct dict_vector dict_linear_vector =
   {
     DICT_LINEAR,			/* type */
@@ -346,23 +372,51 @@ static void insert_symbol_hashed (struct dictionary *dict,
 
 static void expand_hashtable (struct dictionary *dict);
 
+static unsigned int probed_hash (const char *name);
+
+static struct symbol *iterator_probed_advance (struct dict_iterator *iter);
+
 /* The creation functions.  */
 
-/* Create a dictionary implemented via a fixed-size hashtable.  All
-   memory it uses is allocated on OBSTACK; the environment is
-   initialized from SYMBOL_LIST.  */
+/* Create a dictionary implemented via a hashtable that grows as
+   necessary.  The dictionary is initially empty; to add symbols to
+   it, call dict_add_symbol().  Call dict_free() when you're done with
+   it.  */
+
+extern struct dictionary *
+dict_create_hashed_expandable (void)
+{
+  struct dictionary *retval = XNEW (struct dictionary);
+
+  DICT_VECTOR (retval) = &dict_hashed_expandable_vector;
+  DICT_HASHED_NBUCKETS (retval) = DICT_EXPANDABLE_INITIAL_CAPACITY;
+  DICT_HASHED_BUCKETS (retval) = XCNEWVEC (struct symbol *,
+					   DICT_EXPANDABLE_INITIAL_CAPACITY);
+  DICT_HASHED_EXPANDABLE_NSYMS (retval) = 0;
+
+  return retval;
+}
+
+/* Create a dictionary implemented via a fixed-size open-addressed
+   hashtable, which caches the hash of each symbol so that lookups
+   only compare the names of symbols whose hash matches.  All memory
+   it uses is allocated on OBSTACK; the environment is initialized
+   from SYMBOL_LIST.  Symbols with equivalent names are found in the
+   order they appear in SYMBOL_LIST.  */
 
 struct dictionary *
-dict_create_hashed (struct obstack *obstack,
+dict_create_probed (struct obstack *obstack,
 		    const struct pending *symbol_list)
 {
   struct dictionary *retval;
-  int nsyms = 0, nbuckets, i;
-  struct symbol **buckets;
+  int nsyms = 0, nslots, i, j;
+  unsigned int *hashes;
+  struct symbol **slots, **syms;
   const struct pending *list_counter;
+  struct cleanup *cleanups;
 
   retval = XOBNEW (obstack, struct dictionary);
-  DICT_VECTOR (retval) = &dict_hashed_vector;
+  DICT_VECTOR (retval) = &dict_probed_vector;
 
   /* Calculate the number of symbols, and allocate space for them.  */
   for (list_counter = symbol_list;
@@ -371,42 +425,47 @@ dict_create_hashed (struct obstack *obstack,
     {
       nsyms += list_counter->nsyms;
     }
-  nbuckets = DICT_HASHTABLE_SIZE (nsyms);
-  DICT_HASHED_NBUCKETS (retval) = nbuckets;
-  buckets = XOBNEWVEC (obstack, struct symbol *, nbuckets);
-  memset (buckets, 0, nbuckets * sizeof (struct symbol *));
-  DICT_HASHED_BUCKETS (retval) = buckets;
-
-  /* Now fill the buckets.  */
-  for (list_counter = symbol_list;
+  for (nslots = 1; nslots < DICT_PROBED_MIN_SLOTS (nsyms); nslots *= 2)
+    ;
+  DICT_PROBED_NSLOTS (retval) = nslots;
+  hashes = XOBNEWVEC (obstack, unsigned int, nslots);
+  memset (hashes, 0, nslots * sizeof (unsigned int));
+  DICT_PROBED_HASHES (retval) = hashes;
+  slots = XOBNEWVEC (obstack, struct symbol *, nslots);
+  memset (slots, 0, nslots * sizeof (struct symbol *));
+  DICT_PROBED_SYMS (retval) = slots;
+
+  /* Put the symbols in their original order first, as
+     dict_create_linear does: with linear probing, symbols inserted
+     earlier are found first.  */
+  syms = XNEWVEC (struct symbol *, nsyms);
+  cleanups = make_cleanup (xfree, syms);
+  for (list_counter = symbol_list, j = nsyms - 1;
        list_counter != NULL;
        list_counter = list_counter->next)
     {
-      for (i = list_counter->nsyms - 1; i >= 0; --i)
+      for (i = list_counter->nsyms - 1;
+	   i >= 0;
+	   --i, --j)
 	{
-	  insert_symbol_hashed (retval, list_counter->symbol[i]);
+	  syms[j] = list_counter->symbol[i];
 	}
     }
 
-  return retval;
-}
-
-/* Create a dictionary implemented via a hashtable that grows as
-   necessary.  The dictionary is initially empty; to add symbols to
-   it, call dict_add_symbol().  Call dict_free() when you're done with
-   it.  */
-
-extern struct dictionary *
-dict_create_hashed_expandable (void)
-{
-  struct dictionary *retval = XNEW (struct dictionary);
-
-  DICT_VECTOR (retval) = &dict_hashed_expandable_vector;
-  DICT_HASHED_NBUCKETS (retval) = DICT_EXPANDABLE_INITIAL_CAPACITY;
-  DICT_HASHED_BUCKETS (retval) = XCNEWVEC (struct symbol *,
-					   DICT_EXPANDABLE_INITIAL_CAPACITY);
-  DICT_HASHED_EXPANDABLE_NSYMS (retval) = 0;
+  /* Now fill the slots.  */
+  for (i = 0; i < nsyms; i++)
+    {
+      unsigned int hash = probed_hash (SYMBOL_SEARCH_NAME (syms[i]));
+
+      for (j = (hash ^ (hash >> 16)) & (nslots - 1);
+	   hashes[j] != 0;
+	   j = (j + 1) & (nslots - 1))
+	;
+      hashes[j] = hash;
+      slots[j] = syms[i];
+    }
 
+  do_cleanups (cleanups);
   return retval;
 }
 
@@ -598,7 +657,7 @@ add_symbol_nonexpandable (struct dictionary *dict, struct symbol *sym)
 		  _("dict_add_symbol: non-expandable dictionary"));
 }
 
-/* Functions for DICT_HASHED and DICT_HASHED_EXPANDABLE.  */
+/* Functions for DICT_HASHED_EXPANDABLE.  */
 
 static struct symbol *
 iterator_first_hashed (const struct dictionary *dict,
@@ -711,14 +770,6 @@ insert_symbol_hashed (struct dictionary *dict,
   buckets[hash_index] = sym;
 }
 
-static int
-size_hashed (const struct dictionary *dict)
-{
-  return DICT_HASHED_NBUCKETS (dict);
-}
-
-/* Functions only for DICT_HASHED_EXPANDABLE.  */
-
 static void
 free_hashed_expandable (struct dictionary *dict)
 {
@@ -854,6 +905,113 @@ dict_hash (const char *string0)
   return hash;
 }
 
+/* Functions for DICT_PROBED.  */
+
+/* The hash of NAME stored in a DICT_PROBED dictionary.  This is
+   dict_hash, so that names that compare equal still hash the same,
+   except that 0 is reserved to mark empty slots.  */
+
+static unsigned int
+probed_hash (const char *name)
+{
+  unsigned int hash = dict_hash (name);
+
+  return hash != 0 ? hash : 1;
+}
+
+static struct symbol *
+iterator_first_probed (const struct dictionary *dict,
+		       struct dict_iterator *iterator)
+{
+  DICT_ITERATOR_DICT (iterator) = dict;
+  DICT_ITERATOR_INDEX (iterator) = -1;
+  return iterator_probed_advance (iterator);
+}
+
+static struct symbol *
+iterator_next_probed (struct dict_iterator *iterator)
+{
+  return iterator_probed_advance (iterator);
+}
+
+static struct symbol *
+iterator_probed_advance (struct dict_iterator *iterator)
+{
+  const struct dictionary *dict = DICT_ITERATOR_DICT (iterator);
+  const unsigned int *hashes = DICT_PROBED_HASHES (dict);
+  int nslots = DICT_PROBED_NSLOTS (dict);
+  int i;
+
+  for (i = DICT_ITERATOR_INDEX (iterator) + 1; i < nslots; ++i)
+    {
+      if (hashes[i] != 0)
+	{
+	  DICT_ITERATOR_INDEX (iterator) = i;
+	  DICT_ITERATOR_CURRENT (iterator) = DICT_PROBED_SYMS (dict)[i];
+	  return DICT_ITERATOR_CURRENT (iterator);
+	}
+    }
+
+  return NULL;
+}
+
+/* Starting at slot START of the dictionary of ITERATOR, find the
+   first symbol whose SYMBOL_SEARCH_NAME matches NAME according to
+   COMPARE, stopping at the first empty slot.  */
+
+static struct symbol *
+iter_match_probed (unsigned int start, const char *name,
+		   symbol_compare_ftype *compare,
+		   struct dict_iterator *iterator)
+{
+  const struct dictionary *dict = DICT_ITERATOR_DICT (iterator);
+  const unsigned int *hashes = DICT_PROBED_HASHES (dict);
+  struct symbol **syms = DICT_PROBED_SYMS (dict);
+  unsigned int mask = DICT_PROBED_NSLOTS (dict) - 1;
+  unsigned int hash = probed_hash (name);
+  unsigned int i;
+
+  for (i = start & mask; hashes[i] != 0; i = (i + 1) & mask)
+    {
+      /* Warning: the order of arguments to compare matters!  */
+      if (hashes[i] == hash
+	  && compare (SYMBOL_SEARCH_NAME (syms[i]), name) == 0)
+	{
+	  DICT_ITERATOR_INDEX (iterator) = i;
+	  DICT_ITERATOR_CURRENT (iterator) = syms[i];
+	  return syms[i];
+	}
+    }
+
+  DICT_ITERATOR_CURRENT (iterator) = NULL;
+  return NULL;
+}
+
+static struct symbol *
+iter_match_first_probed (const struct dictionary *dict, const char *name,
+			 symbol_compare_ftype *compare,
+			 struct dict_iterator *iterator)
+{
+  unsigned int hash = probed_hash (name);
+
+  DICT_ITERATOR_DICT (iterator) = dict;
+  return iter_match_probed (hash ^ (hash >> 16), name, compare, iterator);
+}
+
+static struct symbol *
+iter_match_next_probed (const char *name, symbol_compare_ftype *compare,
+			struct dict_iterator *iterator)
+{
+  return iter_match_probed (DICT_ITERATOR_INDEX (iterator) + 1, name,
+			    compare, iterator);
+}
+
+static int
+size_probed (const struct dictionary *dict)
+{
+  return DICT_PROBED_NSLOTS (dict);
+}
+
 /* Functions for DICT_LINEAR and DICT_LINEAR_EXPANDABLE.  */
 
 static struct symbol *
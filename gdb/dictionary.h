@@ -40,14 +40,6 @@ struct pending;
 /* The creation functions for various implementations of
    dictionaries.  */
 
-/* Create a dictionary implemented via a fixed-size hashtable.  All
-   memory it uses is allocated on OBSTACK; the environment is
-   initialized from SYMBOL_LIST.  */
-
-extern struct dictionary *dict_create_hashed (struct obstack *obstack,
-					      const struct pending
-					      *symbol_list);
-
 /* Create a dictionary implemented via a hashtable that grows as
    necessary.  The dictionary is initially empty; to add symbols to
    it, call dict_add_symbol().  Call dict_free() when you're done with
@@ -55,6 +47,15 @@ extern struct dictionary *dict_create_hashed (struct obstack *obstack,
 
 extern struct dictionary *dict_create_hashed_expandable (void);
 
+/* Create a dictionary implemented via a fixed-size open-addressed
+   hashtable that also stores the hash of each symbol.  All memory it
+   uses is allocated on OBSTACK; the environment is initialized from
+   SYMBOL_LIST.  */
+
+extern struct dictionary *dict_create_probed (struct obstack *obstack,
+					      const struct pending
+					      *symbol_list);
+
 /* Create a dictionary implemented via a fixed-size array.  All memory
    it uses is allocated on OBSTACK; the environment is initialized
    from the SYMBOL_LIST.  The symbols are ordered in the same order
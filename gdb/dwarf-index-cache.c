@@ -0,0 +1,556 @@
+/* Caching of GDB/DWARF index files.
+
+   Copyright (C) 2015 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "defs.h"
+#include "dwarf-index-cache.h"
+#include "bfd.h"
+#include "build-id.h"
+#include "objfiles.h"
+#include "symfile.h"
+#include "gdbcmd.h"
+#include "cli/cli-setshow.h"
+#include "filestuff.h"
+#include "filenames.h"
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <utime.h>
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
+
+/* The suffix of the cached index files.  */
+#define INDEX_CACHE_SUFFIX ".gdb-index"
+
+/* Nonzero if the index cache is enabled.  */
+static int index_cache_enabled;
+
+/* The directory holding the cached index files.  */
+static char *index_cache_directory;
+
+/* The maximum total size of the cached index files, in megabytes, or
+   -1 for no limit.  */
+static int index_cache_size_limit = 1024;
+
+/* Statistics of this session.  */
+static unsigned int index_cache_hits;
+static unsigned int index_cache_misses;
+static unsigned int index_cache_stores;
+
+/* Debugging of the index cache.  */
+static unsigned int debug_index_cache;
+
+/* The cached contents of an index file, as returned by
+   index_cache_lookup.  */
+
+struct index_cache_handle
+{
+  gdb_byte *contents;
+  size_t size;
+
+  /* Nonzero if CONTENTS is mapped, zero if it is malloced.  */
+  int mapped;
+};
+
+/* Return nonzero if the index cache is enabled and has a directory.
+   There is no directory when neither XDG_CACHE_HOME nor HOME is set
+   and the user did not set one.  */
+
+static int
+index_cache_usable_p (void)
+{
+  return index_cache_enabled && index_cache_directory[0] != '\0';
+}
+
+/* Return the name of the cached index file for BUILD_ID, or for its
+   temporary version if TEMP is nonzero.  The result is malloced.  */
+
+static char *
+index_cache_file_name (const struct bfd_build_id *build_id, int temp)
+{
+  char *name, *p;
+  bfd_size_type i;
+
+  name = (char *) xmalloc (strlen (index_cache_directory) + 1
+			   + 2 * build_id->size
+			   + strlen (INDEX_CACHE_SUFFIX) + 32);
+  p = name + sprintf (name, "%s%s", index_cache_directory, SLASH_STRING);
+  for (i = 0; i < build_id->size; i++)
+    p += sprintf (p, "%02x", (unsigned) build_id->data[i]);
+  p += sprintf (p, "%s", INDEX_CACHE_SUFFIX);
+  if (temp)
+    sprintf (p, ".tmp.%ld", (long) getpid ());
+
+  return name;
+}
+
+/* Create DIR and its parents, as needed.  Return 0 on success, -1 on
+   failure with errno set.  */
+
+static int
+index_cache_make_directory (const char *dir)
+{
+  char *copy = xstrdup (dir);
+  char *p;
+  int result = 0;
+
+  /* Don't try to create the root directory.  */
+  p = copy;
+  if (IS_DIR_SEPARATOR (*p))
+    p++;
+
+  for (; result == 0; p++)
+    {
+      if (*p != '\0' && !IS_DIR_SEPARATOR (*p))
+	continue;
+
+      {
+	char saved = *p;
+
+	*p = '\0';
+#ifdef USE_WIN32API
+	if (mkdir (copy) != 0 && errno != EEXIST)
+#else
+	if (mkdir (copy, 0700) != 0 && errno != EEXIST)
+#endif
+	  result = -1;
+	*p = saved;
+	if (saved == '\0')
+	  break;
+      }
+    }
+
+  xfree (copy);
+  return result;
+}
+
+/* A cached index file, as seen by index_cache_evict.  */
+
+struct index_cache_entry
+{
+  char *name;
+  time_t mtime;
+  off_t size;
+};
+
+/* qsort comparison function for struct index_cache_entry, oldest
+   first.  */
+
+static int
+index_cache_entry_cmp (const void *a, const void *b)
+{
+  const struct index_cache_entry *ea = (const struct index_cache_entry *) a;
+  const struct index_cache_entry *eb = (const struct index_cache_entry *) b;
+
+  if (ea->mtime != eb->mtime)
+    return ea->mtime < eb->mtime ? -1 : 1;
+  return strcmp (ea->name, eb->name);
+}
+
+/* Remove the least recently used index files from the cache until
+   their total size is within the size limit.  Lookups update the
+   modification time of the files they use.  */
+
+static void
+index_cache_evict (void)
+{
+  struct index_cache_entry *entries = NULL;
+  int num_entries = 0, allocated = 0;
+  off_t total = 0, limit;
+  struct dirent *ent;
+  DIR *dir;
+  int i;
+
+  if (index_cache_size_limit == -1)
+    return;
+  limit = (off_t) index_cache_size_limit * 1024 * 1024;
+
+  dir = opendir (index_cache_directory);
+  if (dir == NULL)
+    return;
+
+  while ((ent = readdir (dir)) != NULL)
+    {
+      size_t len = strlen (ent->d_name);
+      size_t suffix_len = strlen (INDEX_CACHE_SUFFIX);
+      struct stat st;
+      char *name;
+
+      if (len <= suffix_len
+	  || strcmp (ent->d_name + len - suffix_len, INDEX_CACHE_SUFFIX) != 0)
+	continue;
+
+      name = concat (index_cache_directory, SLASH_STRING, ent->d_name,
+		     (char *) NULL);
+      if (stat (name, &st) != 0 || !S_ISREG (st.st_mode))
+	{
+	  xfree (name);
+	  continue;
+	}
+
+      if (num_entries == allocated)
+	{
+	  allocated = allocated ? 2 * allocated : 64;
+	  entries = XRESIZEVEC (struct index_cache_entry, entries, allocated);
+	}
+      entries[num_entries].name = name;
+      entries[num_entries].mtime = st.st_mtime;
+      entries[num_entries].size = st.st_size;
+      num_entries++;
+      total += st.st_size;
+    }
+  closedir (dir);
+
+  if (total > limit)
+    {
+      qsort (entries, num_entries, sizeof (entries[0]),
+	     index_cache_entry_cmp);
+      for (i = 0; i < num_entries && total > limit; i++)
+	{
+	  if (debug_index_cache)
+	    fprintf_unfiltered (gdb_stdlog, "index-cache: evicting %s\n",
+				entries[i].name);
+	  if (unlink (entries[i].name) == 0)
+	    total -= entries[i].size;
+	}
+    }
+
+  for (i = 0; i < num_entries; i++)
+    xfree (entries[i].name);
+  xfree (entries);
+}
+
+/* See dwarf-index-cache.h.  */
+
+void
+index_cache_store (struct objfile *objfile)
+{
+  const struct bfd_build_id *build_id;
+  char *name, *temp_name;
+  struct cleanup *cleanups;
+
+  if (!index_cache_usable_p () || objfile->obfd == NULL)
+    return;
+
+  build_id = build_id_bfd_get (objfile->obfd);
+  if (build_id == NULL)
+    return;
+
+  name = index_cache_file_name (build_id, 0);
+  cleanups = make_cleanup (xfree, name);
+  temp_name = index_cache_file_name (build_id, 1);
+  make_cleanup (xfree, temp_name);
+
+  TRY
+    {
+      if (index_cache_make_directory (index_cache_directory) != 0)
+	perror_with_name (index_cache_directory);
+
+      if (dwarf2_write_index (objfile, temp_name))
+	{
+	  if (rename (temp_name, name) != 0)
+	    {
+	      unlink (temp_name);
+	      perror_with_name (name);
+	    }
+
+	  index_cache_stores++;
+	  if (debug_index_cache)
+	    fprintf_unfiltered (gdb_stdlog, "index-cache: stored %s for %s\n",
+				name, objfile_name (objfile));
+
+	  index_cache_evict ();
+	}
+    }
+  CATCH (except, RETURN_MASK_ERROR)
+    {
+      if (debug_index_cache)
+	exception_fprintf (gdb_stdlog, except,
+			   _("index-cache: couldn't store the index of %s: "),
+			   objfile_name (objfile));
+    }
+  END_CATCH
+
+  do_cleanups (cleanups);
+}
+
+/* See dwarf-index-cache.h.  */
+
+const gdb_byte *
+index_cache_lookup (const struct bfd_build_id *build_id, size_t *size,
+		    void **handle)
+{
+  struct index_cache_handle *result;
+  struct stat st;
+  char *name;
+  int fd;
+
+  if (!index_cache_usable_p () || build_id == NULL)
+    return NULL;
+
+  name = index_cache_file_name (build_id, 0);
+  fd = gdb_open_cloexec (name, O_RDONLY | O_BINARY, 0);
+  if (fd < 0 || fstat (fd, &st) != 0 || st.st_size == 0)
+    {
+      if (fd >= 0)
+	close (fd);
+      if (debug_index_cache)
+	fprintf_unfiltered (gdb_stdlog, "index-cache: no %s\n", name);
+      index_cache_misses++;
+      xfree (name);
+      return NULL;
+    }
+
+  result = XCNEW (struct index_cache_handle);
+  result->size = st.st_size;
+
+#ifdef HAVE_MMAP
+  result->contents = (gdb_byte *) mmap (NULL, result->size, PROT_READ,
+					MAP_PRIVATE, fd, 0);
+  if (result->contents != (gdb_byte *) MAP_FAILED)
+    result->mapped = 1;
+  else
+#endif
+    {
+      size_t done = 0;
+
+      result->contents = (gdb_byte *) xmalloc (result->size);
+      while (done < result->size)
+	{
+	  ssize_t n = read (fd, result->contents + done, result->size - done);
+
+	  if (n <= 0)
+	    break;
+	  done += n;
+	}
+      if (done < result->size)
+	{
+	  close (fd);
+	  xfree (result->contents);
+	  xfree (result);
+	  index_cache_misses++;
+	  xfree (name);
+	  return NULL;
+	}
+    }
+  close (fd);
+
+  /* Mark the file as recently used, for index_cache_evict.  */
+  utime (name, NULL);
+
+  if (debug_index_cache)
+    fprintf_unfiltered (gdb_stdlog, "index-cache: using %s\n", name);
+  index_cache_hits++;
+  xfree (name);
+
+  *size = result->size;
+  *handle = result;
+  return result->contents;
+}
+
+/* See dwarf-index-cache.h.  */
+
+void
+index_cache_release (void *arg)
+{
+  struct index_cache_handle *handle = (struct index_cache_handle *) arg;
+
+#ifdef HAVE_MMAP
+  if (handle->mapped)
+    munmap (handle->contents, handle->size);
+  else
+#endif
+    xfree (handle->contents);
+  xfree (handle);
+}
+
+/* The "set index-cache" and "show index-cache" command lists.  */
+static struct cmd_list_element *set_index_cache_list;
+static struct cmd_list_element *show_index_cache_list;
+
+/* Implement "set index-cache".  */
+
+static void
+set_index_cache_command (char *arg, int from_tty)
+{
+  printf_unfiltered (_("\"set index-cache\" must be followed "
+		       "by an appropriate subcommand.\n"));
+  help_list (set_index_cache_list, "set index-cache ", all_commands,
+	     gdb_stdout);
+}
+
+/* Implement "set index-cache on".  */
+
+static void
+set_index_cache_on_command (char *arg, int from_tty)
+{
+  index_cache_enabled = 1;
+
+  if (index_cache_directory[0] == '\0')
+    warning (_("The index cache has no directory, and will not be used "
+	       "until one is set with \"set index-cache directory\"."));
+}
+
+/* Implement "set index-cache off".  */
+
+static void
+set_index_cache_off_command (char *arg, int from_tty)
+{
+  index_cache_enabled = 0;
+}
+
+/* Implement "show index-cache".  */
+
+static void
+show_index_cache_command (char *arg, int from_tty)
+{
+  printf_unfiltered (_("The index cache is %s.\n"),
+		     index_cache_enabled ? _("on") : _("off"));
+  cmd_show_list (show_index_cache_list, from_tty, "");
+}
+
+/* Implement "set index-cache directory".  Make the directory
+   absolute.  */
+
+static void
+set_index_cache_directory (char *arg, int from_tty,
+			   struct cmd_list_element *c)
+{
+  char *dir = gdb_abspath (index_cache_directory);
+
+  xfree (index_cache_directory);
+  index_cache_directory = dir;
+}
+
+/* Implement "show index-cache directory".  */
+
+static void
+show_index_cache_directory (struct ui_file *file, int from_tty,
+			    struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file, _("The directory of the index cache is "
+			    "\"%s\".\n"), value);
+}
+
+/* Implement "show index-cache size-limit".  */
+
+static void
+show_index_cache_size_limit (struct ui_file *file, int from_tty,
+			     struct cmd_list_element *c, const char *value)
+{
+  if (index_cache_size_limit == -1)
+    fprintf_filtered (file, _("The size of the index cache "
+			      "is unlimited.\n"));
+  else
+    fprintf_filtered (file, _("The size of the index cache is limited "
+			      "to %s megabytes.\n"), value);
+}
+
+/* Implement "show index-cache stats".  */
+
+static void
+show_index_cache_stats_command (char *arg, int from_tty)
+{
+  printf_unfiltered (_("Cache hits (this session): %u\n"),
+		     index_cache_hits);
+  printf_unfiltered (_("Cache misses (this session): %u\n"),
+		     index_cache_misses);
+  printf_unfiltered (_("Indices stored (this session): %u\n"),
+		     index_cache_stores);
+}
+
+/* Implement "show debug index-cache".  */
+
+static void
+show_debug_index_cache (struct ui_file *file, int from_tty,
+			struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file, _("Index cache debugging is %s.\n"), value);
+}
+
+/* Provide a prototype to silence -Wmissing-prototypes.  */
+extern initialize_file_ftype _initialize_index_cache;
+
+void
+_initialize_index_cache (void)
+{
+  const char *base = getenv ("XDG_CACHE_HOME");
+
+  if (base != NULL && IS_ABSOLUTE_PATH (base))
+    index_cache_directory = concat (base, SLASH_STRING, "gdb",
+				    (char *) NULL);
+  else
+    {
+      base = getenv ("HOME");
+      if (base != NULL)
+	index_cache_directory = concat (base, SLASH_STRING, ".cache",
+					SLASH_STRING, "gdb", (char *) NULL);
+      else
+	index_cache_directory = xstrdup ("");
+    }
+
+  add_prefix_cmd ("index-cache", class_files, set_index_cache_command,
+		  _("Set index-cache options."), &set_index_cache_list,
+		  "set index-cache ", 0, &setlist);
+  add_prefix_cmd ("index-cache", class_files, show_index_cache_command,
+		  _("Show index-cache options."), &show_index_cache_list,
+		  "show index-cache ", 0, &showlist);
+
+  add_cmd ("on", class_files, set_index_cache_on_command, _("\
+Enable the index cache.\n\
+When on, GDB writes the index of each object file without a\n\
+.gdb_index section to the cache directory, under its build-id, after\n\
+reading its partial symbols, and later uses the cached index instead\n\
+of reading the partial symbols again."),
+	   &set_index_cache_list);
+  add_cmd ("off", class_files, set_index_cache_off_command, _("\
+Disable the index cache."),
+	   &set_index_cache_list);
+
+  add_setshow_filename_cmd ("directory", class_files, &index_cache_directory,
+			    _("\
+Set the directory of the index cache."), _("\
+Show the directory of the index cache."), NULL,
+			    set_index_cache_directory,
+			    show_index_cache_directory,
+			    &set_index_cache_list, &show_index_cache_list);
+
+  add_setshow_zuinteger_unlimited_cmd ("size-limit", class_files,
+				       &index_cache_size_limit, _("\
+Set the maximum size of the index cache, in megabytes."), _("\
+Show the maximum size of the index cache, in megabytes."), _("\
+When storing an index makes the cache bigger than this, the least\n\
+recently used index files are removed.  \"unlimited\" disables the\n\
+limit."),
+				       NULL, show_index_cache_size_limit,
+				       &set_index_cache_list,
+				       &show_index_cache_list);
+
+  add_cmd ("stats", class_files, show_index_cache_stats_command, _("\
+Show some stats about the index cache."),
+	   &show_index_cache_list);
+
+  add_setshow_zuinteger_cmd ("index-cache", class_maintenance,
+			     &debug_index_cache, _("\
+Set index cache debugging."), _("\
+Show index cache debugging."), _("\
+When non-zero, index cache specific debugging is enabled."),
+			     NULL, show_debug_index_cache,
+			     &setdebuglist, &showdebuglist);
+}
@@ -0,0 +1,49 @@
+/* Caching of GDB/DWARF index files.
+
+   Copyright (C) 2015 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef DWARF_INDEX_CACHE_H
+#define DWARF_INDEX_CACHE_H
+
+struct objfile;
+struct bfd_build_id;
+
+/* The index cache keeps the .gdb_index that GDB builds for an objfile
+   without one in a directory, under the objfile's build-id, so that
+   later sessions can use it instead of reading partial symbols.  */
+
+/* Write the index of OBJFILE, whose partial symbols have just been
+   read, to the cache, if the cache is enabled and OBJFILE has a
+   build-id.  Failures are not reported, except under "set debug
+   index-cache".  */
+
+extern void index_cache_store (struct objfile *objfile);
+
+/* Look up the cached index of the objfile whose build-id is BUILD_ID.
+   If there is one, return its contents, store its size into *SIZE,
+   and store into *HANDLE a handle to pass to index_cache_release once
+   the contents are no longer needed.  Otherwise return NULL.  */
+
+extern const gdb_byte *index_cache_lookup (const struct bfd_build_id *build_id,
+					   size_t *size, void **handle);
+
+/* Release the cached index contents associated with HANDLE.  */
+
+extern void index_cache_release (void *handle);
+
+#endif /* DWARF_INDEX_CACHE_H */
@@ -38,6 +38,7 @@
 #include "ax.h"
 #include "dwarf2loc.h"
 #include "dwarf2-frame-tailcall.h"
+#include "gdbcmd.h"
 
 struct comp_unit;
 
@@ -125,6 +126,10 @@ struct dwarf2_fde_table
 {
   int num_entries;
   struct dwarf2_fde **entries;
+
+  /* One past the highest address covered by ENTRIES, before
+     relocation, or 0 if that would not fit in a CORE_ADDR.  */
+  CORE_ADDR end;
 };
 
 /* A minimal decoding of DWARF2 compilation units.  We only decode
@@ -156,6 +161,18 @@ struct comp_unit
 static struct dwarf2_fde *dwarf2_frame_find_fde (CORE_ADDR *pc,
 						 CORE_ADDR *out_offset);
 
+struct dwarf2_frame_state;
+struct dwarf2_frame_cache;
+
+static int dwarf2_frame_find_rules (struct gdbarch *gdbarch, CORE_ADDR pc,
+				    int entry_pc_p, CORE_ADDR entry_pc,
+				    struct dwarf2_frame_state *fs,
+				    struct dwarf2_frame_cache *cache);
+static void dwarf2_frame_save_rules (struct gdbarch *gdbarch, CORE_ADDR pc,
+				     int entry_pc_p, CORE_ADDR entry_pc,
+				     struct dwarf2_frame_state *fs,
+				     struct dwarf2_frame_cache *cache);
+
 static int dwarf2_frame_adjust_regnum (struct gdbarch *gdbarch, int regnum,
 				       int eh_frame_p);
 
@@ -1031,7 +1048,9 @@ dwarf2_frame_cache (struct frame_info *this_frame, void **this_cache)
   struct dwarf2_frame_cache *cache;
   struct dwarf2_frame_state *fs;
   struct dwarf2_fde *fde;
-  CORE_ADDR entry_pc;
+  CORE_ADDR block_addr;
+  CORE_ADDR entry_pc = 0;
+  int entry_pc_p;
   const gdb_byte *instr;
 
   if (*this_cache)
@@ -1062,50 +1081,60 @@ dwarf2_frame_cache (struct frame_info *this_frame, void **this_cache)
      get_frame_address_in_block does just this.  It's not clear how
      reliable the method is though; there is the potential for the
      register state pre-call being different to that on return.  */
-  fs->pc = get_frame_address_in_block (this_frame);
+  block_addr = get_frame_address_in_block (this_frame);
+  fs->pc = block_addr;
 
-  /* Find the correct FDE.  */
-  fde = dwarf2_frame_find_fde (&fs->pc, &cache->text_offset);
-  gdb_assert (fde != NULL);
+  entry_pc_p = get_frame_func_if_available (this_frame, &entry_pc);
 
-  /* Extract any interesting information from the CIE.  */
-  fs->data_align = fde->cie->data_alignment_factor;
-  fs->code_align = fde->cie->code_alignment_factor;
-  fs->retaddr_column = fde->cie->return_address_register;
-  cache->addr_size = fde->cie->addr_size;
+  /* Decoding the CFI only depends on the PCs, so reuse the rules of
+     an earlier frame with the same PCs if we have them.  */
+  if (!dwarf2_frame_find_rules (gdbarch, block_addr, entry_pc_p, entry_pc,
+				fs, cache))
+    {
+      /* Find the correct FDE.  */
+      fde = dwarf2_frame_find_fde (&fs->pc, &cache->text_offset);
+      gdb_assert (fde != NULL);
 
-  /* Check for "quirks" - known bugs in producers.  */
-  dwarf2_frame_find_quirks (fs, fde);
+      /* Extract any interesting information from the CIE.  */
+      fs->data_align = fde->cie->data_alignment_factor;
+      fs->code_align = fde->cie->code_alignment_factor;
+      fs->retaddr_column = fde->cie->return_address_register;
+      cache->addr_size = fde->cie->addr_size;
 
-  /* First decode all the insns in the CIE.  */
-  execute_cfa_program (fde, fde->cie->initial_instructions,
-		       fde->cie->end, gdbarch,
-		       get_frame_address_in_block (this_frame), fs);
+      /* Check for "quirks" - known bugs in producers.  */
+      dwarf2_frame_find_quirks (fs, fde);
 
-  /* Save the initialized register set.  */
-  fs->initial = fs->regs;
-  fs->initial.reg = dwarf2_frame_state_copy_regs (&fs->regs);
+      /* First decode all the insns in the CIE.  */
+      execute_cfa_program (fde, fde->cie->initial_instructions,
+			   fde->cie->end, gdbarch, block_addr, fs);
 
-  if (get_frame_func_if_available (this_frame, &entry_pc))
-    {
-      /* Decode the insns in the FDE up to the entry PC.  */
-      instr = execute_cfa_program (fde, fde->instructions, fde->end, gdbarch,
-				   entry_pc, fs);
+      /* Save the initialized register set.  */
+      fs->initial = fs->regs;
+      fs->initial.reg = dwarf2_frame_state_copy_regs (&fs->regs);
 
-      if (fs->regs.cfa_how == CFA_REG_OFFSET
-	  && (gdbarch_dwarf2_reg_to_regnum (gdbarch, fs->regs.cfa_reg)
-	      == gdbarch_sp_regnum (gdbarch)))
+      if (entry_pc_p)
 	{
-	  cache->entry_cfa_sp_offset = fs->regs.cfa_offset;
-	  cache->entry_cfa_sp_offset_p = 1;
+	  /* Decode the insns in the FDE up to the entry PC.  */
+	  instr = execute_cfa_program (fde, fde->instructions, fde->end,
+				       gdbarch, entry_pc, fs);
+
+	  if (fs->regs.cfa_how == CFA_REG_OFFSET
+	      && (gdbarch_dwarf2_reg_to_regnum (gdbarch, fs->regs.cfa_reg)
+		  == gdbarch_sp_regnum (gdbarch)))
+	    {
+	      cache->entry_cfa_sp_offset = fs->regs.cfa_offset;
+	      cache->entry_cfa_sp_offset_p = 1;
+	    }
 	}
-    }
-  else
-    instr = fde->instructions;
+      else
+	instr = fde->instructions;
 
-  /* Then decode the insns in the FDE up to our target PC.  */
-  execute_cfa_program (fde, instr, fde->end, gdbarch,
-		       get_frame_address_in_block (this_frame), fs);
+      /* Then decode the insns in the FDE up to our target PC.  */
+      execute_cfa_program (fde, instr, fde->end, gdbarch, block_addr, fs);
+
+      dwarf2_frame_save_rules (gdbarch, block_addr, entry_pc_p, entry_pc,
+			       fs, cache);
+    }
 
   TRY
     {
@@ -1762,54 +1791,561 @@ bsearch_fde_cmp (const void *key, const void *element)
   return 1;
 }
 
+/* Return the FDE table of OBJFILE, reading it if necessary.  */
+
+static struct dwarf2_fde_table *
+dwarf2_frame_objfile_fde_table (struct objfile *objfile)
+{
+  struct dwarf2_fde_table *fde_table;
+
+  fde_table = ((struct dwarf2_fde_table *)
+	       objfile_data (objfile, dwarf2_frame_objfile_data));
+  if (fde_table == NULL)
+    {
+      dwarf2_build_frame_info (objfile);
+      fde_table = ((struct dwarf2_fde_table *)
+		   objfile_data (objfile, dwarf2_frame_objfile_data));
+    }
+  gdb_assert (fde_table != NULL);
+
+  return fde_table;
+}
+
+/* Search FDE_TABLE, the non-empty FDE table of OBJFILE, for the FDE
+   covering PC.  Return it, and store the text offset of OBJFILE into
+   *OUT_OFFSET, or return NULL if there is none.  */
+
+static struct dwarf2_fde *
+dwarf2_frame_search_fde_table (struct objfile *objfile,
+			       struct dwarf2_fde_table *fde_table,
+			       CORE_ADDR pc, CORE_ADDR *out_offset)
+{
+  struct dwarf2_fde **p_fde;
+  CORE_ADDR offset;
+  CORE_ADDR seek_pc;
+
+  gdb_assert (objfile->section_offsets);
+  offset = ANOFFSET (objfile->section_offsets, SECT_OFF_TEXT (objfile));
+
+  gdb_assert (fde_table->num_entries > 0);
+  if (pc < offset + fde_table->entries[0]->initial_location)
+    return NULL;
+
+  seek_pc = pc - offset;
+  p_fde = ((struct dwarf2_fde **)
+	   bsearch (&seek_pc, fde_table->entries, fde_table->num_entries,
+		    sizeof (fde_table->entries[0]), bsearch_fde_cmp));
+  if (p_fde == NULL)
+    return NULL;
+
+  *out_offset = offset;
+  return *p_fde;
+}
+
+/* The range of addresses covered by the FDEs of one objfile, after
+   relocation.  */
+
+struct dwarf2_frame_index_entry
+{
+  CORE_ADDR low;
+  CORE_ADDR high;
+
+  /* The position of OBJFILE in the objfile list.  When the ranges of
+     several objfiles contain an address, the first objfile in the
+     list that has an FDE for it wins.  */
+  int order;
+
+  struct objfile *objfile;
+  struct dwarf2_fde_table *fde_table;
+};
+
+/* The unwind rules decoded from the CFI for one PC.  These are the
+   parts of a dwarf2_frame_state and a dwarf2_frame_cache that
+   dwarf2_frame_cache fills in before it looks at any register or
+   memory contents, so they can be shared by all frames with the same
+   PC, such as the same function in many threads.  */
+
+struct dwarf2_frame_rules
+{
+  /* The key: the architecture, the address in block of the frame,
+     and the entry PC of its function if ENTRY_PC_P.  */
+  struct gdbarch *gdbarch;
+  CORE_ADDR pc;
+  int entry_pc_p;
+  CORE_ADDR entry_pc;
+
+  /* The value of dwarf2_frame_state's PC after decoding the CFI: the
+     address at which REGS took effect.  */
+  CORE_ADDR state_pc;
+
+  /* The register rules at PC.  REGS.prev is always NULL.  */
+  struct dwarf2_frame_state_reg_info regs;
+
+  ULONGEST retaddr_column;
+  int armcc_cfa_offsets_reversed;
+
+  int addr_size;
+  CORE_ADDR text_offset;
+  LONGEST entry_cfa_sp_offset;
+  int entry_cfa_sp_offset_p;
+};
+
+/* The maximum number of entries in the unwind rules cache.  The cache
+   is emptied when it grows beyond this.  */
+#define DWARF2_FRAME_RULES_CACHE_SIZE 8192
+
+/* Per-program-space data: an index from addresses to objfiles, and a
+   cache of decoded unwind rules.  Both are derived from the objfiles
+   and rebuilt when the objfile list changes.  */
+
+struct dwarf2_frame_pspace_info
+{
+  /* The objfiles_generation this data was built for.  */
+  unsigned long generation;
+
+  /* Nonzero if the index below is up to date.  */
+  int index_valid;
+
+  /* The objfiles with a non-empty FDE table, sorted by LOW.  */
+  struct dwarf2_frame_index_entry *entries;
+  int num_entries;
+
+  /* MAX_HIGH[I] is the highest HIGH of ENTRIES[0] ... ENTRIES[I].  It
+     tells a lookup when to stop looking at earlier entries.  */
+  CORE_ADDR *max_high;
+
+  /* A hash table of struct dwarf2_frame_rules.  */
+  htab_t rules;
+};
+
+static const struct program_space_data *dwarf2_frame_pspace_data;
+
+/* Free the address index of INFO.  */
+
+static void
+dwarf2_frame_free_index (struct dwarf2_frame_pspace_info *info)
+{
+  xfree (info->entries);
+  info->entries = NULL;
+  xfree (info->max_high);
+  info->max_high = NULL;
+  info->num_entries = 0;
+  info->index_valid = 0;
+}
+
+/* The cleanup function for dwarf2_frame_pspace_data.  */
+
+static void
+dwarf2_frame_pspace_data_cleanup (struct program_space *pspace, void *arg)
+{
+  struct dwarf2_frame_pspace_info *info
+    = (struct dwarf2_frame_pspace_info *) arg;
+
+  dwarf2_frame_free_index (info);
+  if (info->rules != NULL)
+    htab_delete (info->rules);
+  xfree (info);
+}
+
+/* hash_f for the unwind rules cache.  */
+
+static hashval_t
+hash_dwarf2_frame_rules (const void *arg)
+{
+  const struct dwarf2_frame_rules *rules
+    = (const struct dwarf2_frame_rules *) arg;
+  hashval_t hash;
+
+  hash = htab_hash_pointer (rules->gdbarch);
+  hash = iterative_hash_object (rules->pc, hash);
+  if (rules->entry_pc_p)
+    hash = iterative_hash_object (rules->entry_pc, hash);
+  return hash;
+}
+
+/* eq_f for the unwind rules cache.  */
+
+static int
+eq_dwarf2_frame_rules (const void *arg1, const void *arg2)
+{
+  const struct dwarf2_frame_rules *rules1
+    = (const struct dwarf2_frame_rules *) arg1;
+  const struct dwarf2_frame_rules *rules2
+    = (const struct dwarf2_frame_rules *) arg2;
+
+  return (rules1->gdbarch == rules2->gdbarch
+	  && rules1->pc == rules2->pc
+	  && rules1->entry_pc_p == rules2->entry_pc_p
+	  && (!rules1->entry_pc_p || rules1->entry_pc == rules2->entry_pc));
+}
+
+/* del_f for the unwind rules cache.  */
+
+static void
+free_dwarf2_frame_rules (void *arg)
+{
+  struct dwarf2_frame_rules *rules = (struct dwarf2_frame_rules *) arg;
+
+  xfree (rules->regs.reg);
+  xfree (rules);
+}
+
+/* Return the dwarf2-frame data of the current program space, with
+   anything computed for an older set of objfiles thrown away.  */
+
+static struct dwarf2_frame_pspace_info *
+get_dwarf2_frame_pspace_info (void)
+{
+  struct dwarf2_frame_pspace_info *info;
+  unsigned long generation = objfiles_generation (current_program_space);
+
+  info = ((struct dwarf2_frame_pspace_info *)
+	  program_space_data (current_program_space,
+			      dwarf2_frame_pspace_data));
+  if (info == NULL)
+    {
+      info = XCNEW (struct dwarf2_frame_pspace_info);
+      info->generation = generation;
+      set_program_space_data (current_program_space,
+			      dwarf2_frame_pspace_data, info);
+    }
+  else if (info->generation != generation)
+    {
+      dwarf2_frame_free_index (info);
+      if (info->rules != NULL)
+	htab_empty (info->rules);
+      info->generation = generation;
+    }
+
+  return info;
+}
+
+/* qsort comparison function for struct dwarf2_frame_index_entry.  */
+
+static int
+dwarf2_frame_index_entry_cmp (const void *a, const void *b)
+{
+  const struct dwarf2_frame_index_entry *ea
+    = (const struct dwarf2_frame_index_entry *) a;
+  const struct dwarf2_frame_index_entry *eb
+    = (const struct dwarf2_frame_index_entry *) b;
+
+  if (ea->low != eb->low)
+    return ea->low < eb->low ? -1 : 1;
+  return ea->order - eb->order;
+}
+
+/* Build the address index of INFO from the objfiles of the current
+   program space, reading their FDE tables as needed.  Only one entry
+   per objfile is sorted, so this is cheap once the FDE tables have
+   been read.  */
+
+static void
+dwarf2_frame_build_index (struct dwarf2_frame_pspace_info *info)
+{
+  struct objfile *objfile;
+  int count = 0;
+  int order = 0;
+  int i;
+
+  ALL_OBJFILES (objfile)
+    count++;
+
+  info->entries = XNEWVEC (struct dwarf2_frame_index_entry, count);
+  info->num_entries = 0;
+
+  ALL_OBJFILES (objfile)
+    {
+      struct dwarf2_fde_table *fde_table;
+      struct dwarf2_frame_index_entry *entry;
+      CORE_ADDR offset;
+
+      fde_table = dwarf2_frame_objfile_fde_table (objfile);
+      order++;
+      if (fde_table->num_entries == 0)
+	continue;
+
+      gdb_assert (objfile->section_offsets);
+      offset = ANOFFSET (objfile->section_offsets, SECT_OFF_TEXT (objfile));
+
+      entry = &info->entries[info->num_entries++];
+      entry->order = order;
+      entry->objfile = objfile;
+      entry->fde_table = fde_table;
+      entry->low = offset + fde_table->entries[0]->initial_location;
+      entry->high = offset + fde_table->end;
+
+      /* If the relocated range wraps around, or an FDE's range
+	 overflows, let the entry reach the top of the address space.
+	 dwarf2_frame_search_fde_table never matches an address below
+	 LOW, so the part that wrapped to low addresses needs no entry.
+	 Covering all addresses instead would make every lookup visit
+	 this entry and all the ones below it.  */
+      if (fde_table->end == 0 || entry->high <= entry->low)
+	entry->high = ~(CORE_ADDR) 0;
+    }
+
+  qsort (info->entries, info->num_entries, sizeof (info->entries[0]),
+	 dwarf2_frame_index_entry_cmp);
+
+  info->max_high = XNEWVEC (CORE_ADDR, info->num_entries);
+  for (i = 0; i < info->num_entries; i++)
+    {
+      info->max_high[i] = info->entries[i].high;
+      if (i > 0 && info->max_high[i - 1] > info->max_high[i])
+	info->max_high[i] = info->max_high[i - 1];
+    }
+
+  info->index_valid = 1;
+}
+
 /* Find the FDE for *PC.  Return a pointer to the FDE, and store the
    inital location associated with it into *PC.  */
 
 static struct dwarf2_fde *
 dwarf2_frame_find_fde (CORE_ADDR *pc, CORE_ADDR *out_offset)
+{
+  struct dwarf2_frame_pspace_info *info = get_dwarf2_frame_pspace_info ();
+  struct dwarf2_frame_index_entry *best = NULL;
+  struct dwarf2_fde *best_fde = NULL;
+  CORE_ADDR best_offset = 0;
+  int lo, hi, i;
+
+  if (!info->index_valid)
+    dwarf2_frame_build_index (info);
+
+  /* Find the first entry starting above *PC.  */
+  lo = 0;
+  hi = info->num_entries;
+  while (lo < hi)
+    {
+      int mid = lo + (hi - lo) / 2;
+
+      if (info->entries[mid].low <= *pc)
+	lo = mid + 1;
+      else
+	hi = mid;
+    }
+
+  /* The ranges of different objfiles may overlap, so look at all the
+     earlier entries that may still reach *PC.  */
+  for (i = lo - 1; i >= 0 && info->max_high[i] > *pc; i--)
+    {
+      struct dwarf2_frame_index_entry *entry = &info->entries[i];
+      struct dwarf2_fde *fde;
+      CORE_ADDR offset;
+
+      if (*pc >= entry->high
+	  || (best != NULL && best->order < entry->order))
+	continue;
+
+      fde = dwarf2_frame_search_fde_table (entry->objfile, entry->fde_table,
+					   *pc, &offset);
+      if (fde != NULL)
+	{
+	  best = entry;
+	  best_fde = fde;
+	  best_offset = offset;
+	}
+    }
+
+  if (best_fde == NULL)
+    return NULL;
+
+  *pc = best_fde->initial_location + best_offset;
+  if (out_offset)
+    *out_offset = best_offset;
+  return best_fde;
+}
+
+/* Find the FDE for *PC by searching the FDE tables of the objfiles in
+   order, without the address index, as dwarf2_frame_find_fde used
+   to.  Used to check the index.  */
+
+static struct dwarf2_fde *
+dwarf2_frame_find_fde_linear (CORE_ADDR *pc, CORE_ADDR *out_offset)
 {
   struct objfile *objfile;
 
   ALL_OBJFILES (objfile)
     {
       struct dwarf2_fde_table *fde_table;
-      struct dwarf2_fde **p_fde;
+      struct dwarf2_fde *fde;
       CORE_ADDR offset;
-      CORE_ADDR seek_pc;
 
-      fde_table = ((struct dwarf2_fde_table *)
-		   objfile_data (objfile, dwarf2_frame_objfile_data));
-      if (fde_table == NULL)
+      fde_table = dwarf2_frame_objfile_fde_table (objfile);
+      if (fde_table->num_entries == 0)
+	continue;
+
+      fde = dwarf2_frame_search_fde_table (objfile, fde_table, *pc, &offset);
+      if (fde != NULL)
 	{
-	  dwarf2_build_frame_info (objfile);
-	  fde_table = ((struct dwarf2_fde_table *)
-		       objfile_data (objfile, dwarf2_frame_objfile_data));
+	  *pc = fde->initial_location + offset;
+	  if (out_offset)
+	    *out_offset = offset;
+	  return fde;
 	}
-      gdb_assert (fde_table != NULL);
+    }
+
+  return NULL;
+}
+
+/* Check that looking up PC through the address index finds the same
+   FDE as the linear search.  Print a message and return 1 if it
+   does not, return 0 otherwise.  */
 
+static int
+dwarf2_frame_check_index_at (CORE_ADDR pc)
+{
+  struct gdbarch *gdbarch = target_gdbarch ();
+  CORE_ADDR indexed_pc = pc, linear_pc = pc;
+  CORE_ADDR indexed_offset = 0, linear_offset = 0;
+  struct dwarf2_fde *indexed, *linear;
+
+  indexed = dwarf2_frame_find_fde (&indexed_pc, &indexed_offset);
+  linear = dwarf2_frame_find_fde_linear (&linear_pc, &linear_offset);
+
+  if (indexed == linear
+      && (indexed == NULL
+	  || (indexed_pc == linear_pc && indexed_offset == linear_offset)))
+    return 0;
+
+  printf_filtered (_("FDE lookup mismatch at %s: the index finds %s, "
+		     "the linear search finds %s.\n"),
+		   paddress (gdbarch, pc),
+		   indexed != NULL ? paddress (gdbarch, indexed_pc) : "none",
+		   linear != NULL ? paddress (gdbarch, linear_pc) : "none");
+  return 1;
+}
+
+/* Implement "maint check-dwarf2-frame-index".  Look up the boundary
+   addresses of every FDE of every objfile through the address index,
+   and compare with a linear search.  */
+
+static void
+maint_check_dwarf2_frame_index (char *args, int from_tty)
+{
+  struct objfile *objfile;
+  int checked = 0;
+  int mismatches = 0;
+
+  ALL_OBJFILES (objfile)
+    {
+      struct dwarf2_fde_table *fde_table;
+      CORE_ADDR offset;
+      int i;
+
+      fde_table = dwarf2_frame_objfile_fde_table (objfile);
       if (fde_table->num_entries == 0)
 	continue;
 
       gdb_assert (objfile->section_offsets);
       offset = ANOFFSET (objfile->section_offsets, SECT_OFF_TEXT (objfile));
 
-      gdb_assert (fde_table->num_entries > 0);
-      if (*pc < offset + fde_table->entries[0]->initial_location)
-        continue;
-
-      seek_pc = *pc - offset;
-      p_fde = ((struct dwarf2_fde **)
-	       bsearch (&seek_pc, fde_table->entries, fde_table->num_entries,
-                        sizeof (fde_table->entries[0]), bsearch_fde_cmp));
-      if (p_fde != NULL)
-        {
-          *pc = (*p_fde)->initial_location + offset;
-	  if (out_offset)
-	    *out_offset = offset;
-          return *p_fde;
-        }
+      for (i = 0; i < fde_table->num_entries; i++)
+	{
+	  struct dwarf2_fde *fde = fde_table->entries[i];
+	  CORE_ADDR start = offset + fde->initial_location;
+	  CORE_ADDR end = start + fde->address_range;
+	  CORE_ADDR addrs[4];
+	  int j;
+
+	  addrs[0] = start - 1;
+	  addrs[1] = start;
+	  addrs[2] = end - 1;
+	  addrs[3] = end;
+	  for (j = 0; j < 4; j++)
+	    {
+	      mismatches += dwarf2_frame_check_index_at (addrs[j]);
+	      checked++;
+	    }
+	}
     }
-  return NULL;
+
+  printf_filtered (_("Checked %d addresses, found %d mismatches.\n"),
+		   checked, mismatches);
+}
+
+/* Look up the unwind rules for PC, ENTRY_PC_P and ENTRY_PC in the
+   cache.  If found, copy them into FS and CACHE and return 1;
+   otherwise return 0.  */
+
+static int
+dwarf2_frame_find_rules (struct gdbarch *gdbarch, CORE_ADDR pc,
+			 int entry_pc_p, CORE_ADDR entry_pc,
+			 struct dwarf2_frame_state *fs,
+			 struct dwarf2_frame_cache *cache)
+{
+  struct dwarf2_frame_pspace_info *info = get_dwarf2_frame_pspace_info ();
+  struct dwarf2_frame_rules key, *rules;
+
+  if (info->rules == NULL)
+    return 0;
+
+  key.gdbarch = gdbarch;
+  key.pc = pc;
+  key.entry_pc_p = entry_pc_p;
+  key.entry_pc = entry_pc;
+  rules = (struct dwarf2_frame_rules *) htab_find (info->rules, &key);
+  if (rules == NULL)
+    return 0;
+
+  fs->pc = rules->state_pc;
+  fs->regs = rules->regs;
+  fs->regs.reg = dwarf2_frame_state_copy_regs (&rules->regs);
+  fs->retaddr_column = rules->retaddr_column;
+  fs->armcc_cfa_offsets_reversed = rules->armcc_cfa_offsets_reversed;
+
+  cache->addr_size = rules->addr_size;
+  cache->text_offset = rules->text_offset;
+  cache->entry_cfa_sp_offset = rules->entry_cfa_sp_offset;
+  cache->entry_cfa_sp_offset_p = rules->entry_cfa_sp_offset_p;
+  return 1;
+}
+
+/* Record the unwind rules FS and CACHE decoded for PC, ENTRY_PC_P and
+   ENTRY_PC in the cache.  */
+
+static void
+dwarf2_frame_save_rules (struct gdbarch *gdbarch, CORE_ADDR pc,
+			 int entry_pc_p, CORE_ADDR entry_pc,
+			 struct dwarf2_frame_state *fs,
+			 struct dwarf2_frame_cache *cache)
+{
+  struct dwarf2_frame_pspace_info *info = get_dwarf2_frame_pspace_info ();
+  struct dwarf2_frame_rules *rules;
+  void **slot;
+
+  if (info->rules == NULL)
+    info->rules = htab_create_alloc (127, hash_dwarf2_frame_rules,
+				     eq_dwarf2_frame_rules,
+				     free_dwarf2_frame_rules,
+				     xcalloc, xfree);
+  else if (htab_elements (info->rules) >= DWARF2_FRAME_RULES_CACHE_SIZE)
+    htab_empty (info->rules);
+
+  rules = XCNEW (struct dwarf2_frame_rules);
+  rules->gdbarch = gdbarch;
+  rules->pc = pc;
+  rules->entry_pc_p = entry_pc_p;
+  rules->entry_pc = entry_pc_p ? entry_pc : 0;
+
+  rules->state_pc = fs->pc;
+  rules->regs = fs->regs;
+  rules->regs.reg = dwarf2_frame_state_copy_regs (&fs->regs);
+  rules->regs.prev = NULL;
+  rules->retaddr_column = fs->retaddr_column;
+  rules->armcc_cfa_offsets_reversed = fs->armcc_cfa_offsets_reversed;
+
+  rules->addr_size = cache->addr_size;
+  rules->text_offset = cache->text_offset;
+  rules->entry_cfa_sp_offset = cache->entry_cfa_sp_offset;
+  rules->entry_cfa_sp_offset_p = cache->entry_cfa_sp_offset_p;
+
+  slot = htab_find_slot (info->rules, rules, INSERT);
+  if (*slot != NULL)
+    free_dwarf2_frame_rules (*slot);
+  *slot = rules;
 }
 
 /* Add a pointer to new FDE to the FDE_TABLE, allocating space for it.  */
@@ -2402,6 +2938,7 @@ dwarf2_build_frame_info (struct objfile *objfile)
   /* Copy fde_table to obstack: it is needed at runtime.  */
   fde_table2 = XOBNEW (&objfile->objfile_obstack, struct dwarf2_fde_table);
 
+  fde_table2->end = 0;
   if (fde_table.num_entries == 0)
     {
       fde_table2->entries = NULL;
@@ -2411,6 +2948,7 @@ dwarf2_build_frame_info (struct objfile *objfile)
     {
       struct dwarf2_fde *fde_prev = NULL;
       struct dwarf2_fde *first_non_zero_fde = NULL;
+      int fde_overflow = 0;
       int i;
 
       /* Prepare FDE table for lookups.  */
@@ -2462,7 +3000,16 @@ dwarf2_build_frame_info (struct objfile *objfile)
 			sizeof (fde_table.entries[0]));
 	  ++fde_table2->num_entries;
 	  fde_prev = fde;
+
+	  if (fde->initial_location + fde->address_range
+	      < fde->initial_location)
+	    fde_overflow = 1;
+	  else if (fde->initial_location + fde->address_range
+		   > fde_table2->end)
+	    fde_table2->end = fde->initial_location + fde->address_range;
 	}
+      if (fde_overflow)
+	fde_table2->end = 0;
       fde_table2->entries
 	= (struct dwarf2_fde **) obstack_finish (&objfile->objfile_obstack);
 
@@ -2481,4 +3028,14 @@ _initialize_dwarf2_frame (void)
 {
   dwarf2_frame_data = gdbarch_data_register_pre_init (dwarf2_frame_init);
   dwarf2_frame_objfile_data = register_objfile_data ();
+  dwarf2_frame_pspace_data
+    = register_program_space_data_with_cleanup (NULL,
+						dwarf2_frame_pspace_data_cleanup);
+
+  add_cmd ("check-dwarf2-frame-index", class_maintenance,
+	   maint_check_dwarf2_frame_index, _("\
+Check the address index used to find DWARF CFI.\n\
+Look up the boundary addresses of every FDE through the index, and\n\
+report the ones for which a linear search finds a different FDE."),
+	   &maintenancelist);
 }
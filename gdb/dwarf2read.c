@@ -70,6 +70,9 @@
 #include "filestuff.h"
 #include "build-id.h"
 #include "namespace.h"
+#include "maint.h"
+#include "worker-threads.h"
+#include "dwarf-index-cache.h"
 
 #include <fcntl.h>
 #include <sys/types.h>
@@ -294,6 +297,11 @@ struct dwarf2_per_objfile
   /* The mapped index, or NULL if .gdb_index is missing or not being used.  */
   struct mapped_index *index_table;
 
+  /* If INDEX_TABLE comes from the index cache rather than from the
+     .gdb_index section, the handle of the cached contents, for
+     index_cache_release.  */
+  void *index_cache_handle;
+
   /* When using index_table, this keeps track of all quick_file_names entries.
      TUs typically share line table entries with a CU, so we maintain a
      separate table of all line table entries to support the sharing.
@@ -3042,44 +3050,35 @@ find_slot_in_mapped_hash (struct mapped_index *index, const char *name,
     }
 }
 
-/* A helper function that reads the .gdb_index from SECTION and fills
-   in MAP.  FILENAME is the name of the file containing the section;
-   it is used for error reporting.  DEPRECATED_OK is nonzero if it is
-   ok to use deprecated sections.
+/* A helper function that reads an index whose contents are the SIZE
+   bytes at ADDR, and fills in MAP.  FILENAME is the name of the file
+   containing the index; it is used for error reporting.  DEPRECATED_OK
+   is nonzero if it is ok to use deprecated indices.
 
    CU_LIST, CU_LIST_ELEMENTS, TYPES_LIST, and TYPES_LIST_ELEMENTS are
    out parameters that are filled in with information about the CU and
-   TU lists in the section.
+   TU lists in the index.
 
    Returns 1 if all went well, 0 otherwise.  */
 
 static int
-read_index_from_section (struct objfile *objfile,
-			 const char *filename,
-			 int deprecated_ok,
-			 struct dwarf2_section_info *section,
-			 struct mapped_index *map,
-			 const gdb_byte **cu_list,
-			 offset_type *cu_list_elements,
-			 const gdb_byte **types_list,
-			 offset_type *types_list_elements)
+read_index_from_contents (const char *filename,
+			  int deprecated_ok,
+			  const gdb_byte *addr,
+			  offset_type size,
+			  struct mapped_index *map,
+			  const gdb_byte **cu_list,
+			  offset_type *cu_list_elements,
+			  const gdb_byte **types_list,
+			  offset_type *types_list_elements)
 {
-  const gdb_byte *addr;
   offset_type version;
   offset_type *metadata;
   int i;
 
-  if (dwarf2_section_empty_p (section))
+  if (size < 6 * sizeof (offset_type))
     return 0;
 
-  /* Older elfutils strip versions could keep the section in the main
-     executable while splitting it for the separate debug info file.  */
-  if ((get_section_flags (section) & SEC_HAS_CONTENTS) == 0)
-    return 0;
-
-  dwarf2_read_section (objfile, section);
-
-  addr = section->buffer;
   /* Version check.  */
   version = MAYBE_SWAP (*(offset_type *) addr);
   /* Versions earlier than 3 emitted every copy of a psymbol.  This
@@ -3132,11 +3131,17 @@ to use the section anyway."),
   if (version > 8)
     return 0;
 
-  map->version = version;
-  map->total_size = section->size;
-
   metadata = (offset_type *) (addr + sizeof (offset_type));
 
+  /* The tables must follow each other within the contents.  */
+  for (i = 0; i < 5; ++i)
+    if (MAYBE_SWAP (metadata[i]) > size
+	|| (i > 0 && MAYBE_SWAP (metadata[i]) < MAYBE_SWAP (metadata[i - 1])))
+      return 0;
+
+  map->version = version;
+  map->total_size = size;
+
   i = 0;
   *cu_list = addr + MAYBE_SWAP (metadata[i]);
   *cu_list_elements = ((MAYBE_SWAP (metadata[i + 1]) - MAYBE_SWAP (metadata[i]))
@@ -3165,9 +3170,81 @@ to use the section anyway."),
   return 1;
 }
 
+/* A helper function that reads the .gdb_index from SECTION and fills
+   in MAP.  FILENAME is the name of the file containing the section;
+   it is used for error reporting.  The other arguments and the result
+   are as for read_index_from_contents.  */
+
+static int
+read_index_from_section (struct objfile *objfile,
+			 const char *filename,
+			 int deprecated_ok,
+			 struct dwarf2_section_info *section,
+			 struct mapped_index *map,
+			 const gdb_byte **cu_list,
+			 offset_type *cu_list_elements,
+			 const gdb_byte **types_list,
+			 offset_type *types_list_elements)
+{
+  if (dwarf2_section_empty_p (section))
+    return 0;
+
+  /* Older elfutils strip versions could keep the section in the main
+     executable while splitting it for the separate debug info file.  */
+  if ((get_section_flags (section) & SEC_HAS_CONTENTS) == 0)
+    return 0;
+
+  dwarf2_read_section (objfile, section);
+
+  return read_index_from_contents (filename, deprecated_ok,
+				   section->buffer, section->size, map,
+				   cu_list, cu_list_elements,
+				   types_list, types_list_elements);
+}
+
+/* A helper function that reads the index of OBJFILE from the index
+   cache, and fills in MAP.  The other arguments and the result are as
+   for read_index_from_contents.  */
+
+static int
+read_index_from_cache (struct objfile *objfile,
+		       struct mapped_index *map,
+		       const gdb_byte **cu_list,
+		       offset_type *cu_list_elements,
+		       const gdb_byte **types_list,
+		       offset_type *types_list_elements)
+{
+  const gdb_byte *contents;
+  size_t size;
+  void *handle;
+
+  /* See dwarf2_write_index.  */
+  if (VEC_length (dwarf2_section_info_def, dwarf2_per_objfile->types) > 1
+      || bfd_get_section_by_name (objfile->obfd, ".gnu_debugaltlink") != NULL)
+    return 0;
+
+  contents = index_cache_lookup (build_id_bfd_get (objfile->obfd),
+				 &size, &handle);
+  if (contents == NULL)
+    return 0;
+
+  if (size != (offset_type) size
+      || !read_index_from_contents (objfile_name (objfile), 0,
+				    contents, size, map,
+				    cu_list, cu_list_elements,
+				    types_list, types_list_elements))
+    {
+      index_cache_release (handle);
+      return 0;
+    }
+
+  dwarf2_per_objfile->index_cache_handle = handle;
+  return 1;
+}
 
-/* Read the index file.  If everything went ok, initialize the "quick"
-   elements of all the CUs and return 1.  Otherwise, return 0.  */
+/* Read the index file, or the cached index of OBJFILE.  If everything
+   went ok, initialize the "quick" elements of all the CUs and return 1.
+   Otherwise, return 0.  */
 
 static int
 dwarf2_read_index (struct objfile *objfile)
@@ -3181,7 +3258,10 @@ dwarf2_read_index (struct objfile *objfile)
 				use_deprecated_index_sections,
 				&dwarf2_per_objfile->gdb_index, &local_map,
 				&cu_list, &cu_list_elements,
-				&types_list, &types_list_elements))
+				&types_list, &types_list_elements)
+      && !read_index_from_cache (objfile, &local_map,
+				 &cu_list, &cu_list_elements,
+				 &types_list, &types_list_elements))
     return 0;
 
   /* Don't use the index if it's empty.  */
@@ -4267,6 +4347,8 @@ dwarf2_build_psymtabs (struct objfile *objfile)
 
       dwarf2_build_psymtabs_hard (objfile);
       discard_cleanups (cleanups);
+
+      index_cache_store (objfile);
     }
   CATCH (except, RETURN_MASK_ERROR)
     {
@@ -6064,10 +6146,12 @@ process_psymtab_comp_unit_reader (const struct die_reader_specs *reader,
 }
 
 /* Subroutine of dwarf2_build_psymtabs_hard to simplify it.
-   Process compilation unit THIS_CU for a psymtab.  */
+   Process compilation unit THIS_CU for a psymtab.  ABBREV_TABLE, if
+   non-NULL, is the already read abbrev table of THIS_CU.  */
 
 static void
 process_psymtab_comp_unit (struct dwarf2_per_cu_data *this_cu,
+			   struct abbrev_table *abbrev_table,
 			   int want_partial_unit,
 			   enum language pretend_language)
 {
@@ -6084,7 +6168,7 @@ process_psymtab_comp_unit (struct dwarf2_per_cu_data *this_cu,
   gdb_assert (! this_cu->is_debug_types);
   info.want_partial_unit = want_partial_unit;
   info.pretend_language = pretend_language;
-  init_cutu_and_read_dies (this_cu, NULL, 0, 0,
+  init_cutu_and_read_dies (this_cu, abbrev_table, 0, 0,
 			   process_psymtab_comp_unit_reader,
 			   &info);
 
@@ -6442,14 +6526,139 @@ set_partial_user (struct objfile *objfile)
     }
 }
 
+/* The number of CUs per worker thread that dwarf2_build_psymtabs_hard
+   reads ahead at a time.  */
+#define PSYMTAB_READ_AHEAD_CUS 16
+
+/* A CU whose abbrev table is read ahead by read_ahead_comp_units.  */
+
+struct read_ahead_cu
+{
+  /* The CU.  */
+  struct dwarf2_per_cu_data *per_cu;
+
+  /* Where its abbrev table is, or NULL if it should be left to
+     init_cutu_and_read_dies.  */
+  struct dwarf2_section_info *abbrev_section;
+  sect_offset abbrev_offset;
+
+  /* The table, once read.  */
+  struct abbrev_table *abbrev_table;
+};
+
+/* A window of CUs being read ahead.  */
+
+struct read_ahead_window
+{
+  /* The number of entries in CUS.  */
+  int size;
+
+  struct read_ahead_cu *cus;
+};
+
+/* A cleanup that frees ARG, a struct read_ahead_window, and any abbrev
+   tables left in it.  */
+
+static void
+free_read_ahead_window (void *arg)
+{
+  struct read_ahead_window *window = (struct read_ahead_window *) arg;
+  int i;
+
+  for (i = 0; i < window->size; i++)
+    if (window->cus[i].abbrev_table != NULL)
+      abbrev_table_free (window->cus[i].abbrev_table);
+  xfree (window->cus);
+  xfree (window);
+}
+
+/* The parallel part of read_ahead_comp_units.  Read the abbrev table
+   of the Ith entry of DATA, an array of struct read_ahead_cu, and
+   touch the CU's DIEs so that they are paged in, in case the section
+   is mapped from the file.  This runs on a worker thread, so it may
+   only do things that can't fail.  If it runs out of memory, the
+   table is left NULL and is read again on the main thread.  */
+
+static void
+read_ahead_comp_unit (int i, void *data)
+{
+  struct read_ahead_cu *ra = &((struct read_ahead_cu *) data)[i];
+  struct dwarf2_per_cu_data *per_cu = ra->per_cu;
+  const gdb_byte *p, *end;
+  volatile gdb_byte sink;
+
+  if (ra->abbrev_section == NULL)
+    return;
+
+  ra->abbrev_table = abbrev_table_read_table (ra->abbrev_section,
+					      ra->abbrev_offset);
+
+  end = per_cu->section->buffer + per_cu->offset.sect_off + per_cu->length;
+  for (p = per_cu->section->buffer + per_cu->offset.sect_off;
+       p < end; p += 4096)
+    sink = *p;
+}
+
+/* Read ahead the abbrev tables of the COUNT CUs starting at index
+   FIRST of all_comp_units into RA, spreading the work over the worker
+   threads.  The sections involved are read in first, here on the main
+   thread, and any CU whose header doesn't look right is left for
+   init_cutu_and_read_dies to complain about.  */
+
+static void
+read_ahead_comp_units (struct objfile *objfile, int first, int count,
+		       struct read_ahead_cu *ra)
+{
+  int i;
+
+  for (i = 0; i < count; i++)
+    {
+      struct dwarf2_per_cu_data *per_cu = dw2_get_cutu (first + i);
+      struct dwarf2_section_info *section = per_cu->section;
+      struct dwarf2_section_info *abbrev_section;
+      struct comp_unit_head header;
+      bfd *abfd;
+
+      ra[i].per_cu = per_cu;
+      ra[i].abbrev_section = NULL;
+      ra[i].abbrev_table = NULL;
+
+      dwarf2_read_section (objfile, section);
+      if (section->buffer == NULL
+	  || per_cu->offset.sect_off + per_cu->length > section->size
+	  || per_cu->length < 11)
+	continue;
+
+      abbrev_section = get_abbrev_section_for_cu (per_cu);
+      dwarf2_read_section (objfile, abbrev_section);
+      if (abbrev_section->buffer == NULL)
+	continue;
+
+      abfd = get_section_bfd_owner (section);
+      if (bfd_get_sign_extend_vma (abfd) < 0)
+	continue;
+      read_comp_unit_head (&header,
+			   section->buffer + per_cu->offset.sect_off, abfd);
+      if (header.version < 2 || header.version > 4
+	  || header.abbrev_offset.sect_off >= abbrev_section->size)
+	continue;
+
+      ra[i].abbrev_section = abbrev_section;
+      ra[i].abbrev_offset = header.abbrev_offset;
+    }
+
+  parallel_for_each (count, read_ahead_comp_unit, ra);
+}
+
 /* Build the partial symbol table by doing a quick pass through the
    .debug_info and .debug_abbrev sections.  */
 
 static void
 dwarf2_build_psymtabs_hard (struct objfile *objfile)
 {
-  struct cleanup *back_to, *addrmap_cleanup;
+  struct cleanup *back_to, *addrmap_cleanup, *window_cleanup;
   struct obstack temp_obstack;
+  struct read_ahead_window *window;
   int i;
 
   if (dwarf_read_debug)
@@ -6458,13 +6667,18 @@ dwarf2_build_psymtabs_hard (struct objfile *objfile)
 			  objfile_name (objfile));
     }
 
+  back_to = make_time_report_cleanup (_("Reading partial symbols of %s "
+					"(%d threads)"),
+				      objfile_name (objfile),
+				      worker_threads_count ());
+
   dwarf2_per_objfile->reading_partial_symbols = 1;
 
   dwarf2_read_section (objfile, &dwarf2_per_objfile->info);
 
   /* Any cached compilation units will be linked by the per-objfile
      read_in_chain.  Make sure to free them when we're done.  */
-  back_to = make_cleanup (free_cached_comp_units, NULL);
+  make_cleanup (free_cached_comp_units, NULL);
 
   build_type_psymtabs (objfile);
 
@@ -6477,12 +6691,39 @@ dwarf2_build_psymtabs_hard (struct objfile *objfile)
   objfile->psymtabs_addrmap = addrmap_create_mutable (&temp_obstack);
   addrmap_cleanup = make_cleanup (psymtabs_addrmap_cleanup, objfile);
 
-  for (i = 0; i < dwarf2_per_objfile->n_comp_units; ++i)
+  /* Reading the DIEs themselves into psymtabs touches too much shared
+     state to be done in parallel, but the abbrev tables can be read,
+     and the DIEs paged in, ahead of time by the worker threads.  Do
+     this a window of CUs at a time to bound the memory used, and
+     process the CUs of each window in order.  */
+  window = XNEW (struct read_ahead_window);
+  window->size = worker_threads_count () * PSYMTAB_READ_AHEAD_CUS;
+  window->cus = XCNEWVEC (struct read_ahead_cu, window->size);
+  window_cleanup = make_cleanup (free_read_ahead_window, window);
+
+  for (i = 0; i < dwarf2_per_objfile->n_comp_units; i += window->size)
     {
-      struct dwarf2_per_cu_data *per_cu = dw2_get_cutu (i);
+      int count = dwarf2_per_objfile->n_comp_units - i;
+      int j;
 
-      process_psymtab_comp_unit (per_cu, 0, language_minimal);
+      if (count > window->size)
+	count = window->size;
+      read_ahead_comp_units (objfile, i, count, window->cus);
+
+      for (j = 0; j < count; j++)
+	{
+	  struct read_ahead_cu *ra = &window->cus[j];
+
+	  process_psymtab_comp_unit (ra->per_cu, ra->abbrev_table,
+				     0, language_minimal);
+	  if (ra->abbrev_table != NULL)
+	    {
+	      abbrev_table_free (ra->abbrev_table);
+	      ra->abbrev_table = NULL;
+	    }
+	}
     }
+  do_cleanups (window_cleanup);
 
   /* This has to wait until we read the CUs, we need the list of DWOs.  */
   process_skeletonless_type_units (objfile);
@@ -6714,7 +6955,7 @@ scan_partial_symbols (struct partial_die_info *first_die, CORE_ADDR *lowpc,
 
 		/* Go read the partial unit, if needed.  */
 		if (per_cu->v.psymtab == NULL)
-		  process_psymtab_comp_unit (per_cu, 1, cu->language);
+		  process_psymtab_comp_unit (per_cu, NULL, 1, cu->language);
 
 		VEC_safe_push (dwarf2_per_cu_ptr,
 			       cu->per_cu->imported_symtabs, per_cu);
@@ -22591,6 +22832,9 @@ dwarf2_per_objfile_free (struct objfile *objfile, void *d)
 
   if (data->dwz_file && data->dwz_file->dwz_bfd)
     gdb_bfd_unref (data->dwz_file->dwz_bfd);
+
+  if (data->index_cache_handle != NULL)
+    index_cache_release (data->index_cache_handle);
 }
 
 
@@ -23276,13 +23520,14 @@ recursively_write_psymbols (struct objfile *objfile,
 		  1);
 }
 
-/* Create an index file for OBJFILE in the directory DIR.  */
+/* Create the index file FILENAME for OBJFILE.  Return 1 if the file
+   was written, or 0 if OBJFILE has nothing to index.  */
 
-static void
-write_psymtabs_to_index (struct objfile *objfile, const char *dir)
+static int
+write_psymtabs_to_index (struct objfile *objfile, const char *filename)
 {
   struct cleanup *cleanup;
-  char *filename, *cleanup_filename;
+  const char *cleanup_filename;
   struct obstack contents, addr_obstack, constant_pool, symtab_obstack;
   struct obstack cu_list, types_cu_list;
   int i;
@@ -23301,21 +23546,17 @@ write_psymtabs_to_index (struct objfile *objfile, const char *dir)
     error (_("Cannot make an index when the file has multiple .debug_types sections"));
 
   if (!objfile->psymtabs || !objfile->psymtabs_addrmap)
-    return;
+    return 0;
 
   if (stat (objfile_name (objfile), &st) < 0)
     perror_with_name (objfile_name (objfile));
 
-  filename = concat (dir, SLASH_STRING, lbasename (objfile_name (objfile)),
-		     INDEX_SUFFIX, (char *) NULL);
-  cleanup = make_cleanup (xfree, filename);
-
   out_file = gdb_fopen_cloexec (filename, "wb");
   if (!out_file)
     error (_("Can't open `%s' for writing"), filename);
 
   cleanup_filename = filename;
-  make_cleanup (unlink_if_set, &cleanup_filename);
+  cleanup = make_cleanup (unlink_if_set, &cleanup_filename);
 
   symtab = create_mapped_symtab ();
   make_cleanup (cleanup_mapped_symtab, symtab);
@@ -23459,6 +23700,28 @@ write_psymtabs_to_index (struct objfile *objfile, const char *dir)
   cleanup_filename = NULL;
 
   do_cleanups (cleanup);
+  return 1;
+}
+
+/* See symfile.h.  */
+
+int
+dwarf2_write_index (struct objfile *objfile, const char *filename)
+{
+  dwarf2_per_objfile
+    = (struct dwarf2_per_objfile *) objfile_data (objfile,
+						  dwarf2_objfile_data_key);
+  if (dwarf2_per_objfile == NULL)
+    return 0;
+
+  /* An index of an objfile with a .dwz file is only usable along with
+     the index of the .dwz file, which we do not write.  */
+  if (dwarf2_per_objfile->dwz_file != NULL
+      || dwarf2_per_objfile->using_index
+      || VEC_length (dwarf2_section_info_def, dwarf2_per_objfile->types) > 1)
+    return 0;
+
+  return write_psymtabs_to_index (objfile, filename);
 }
 
 /* Implementation of the `save gdb-index' command.
@@ -23488,9 +23751,14 @@ save_gdb_index_command (char *arg, int from_tty)
     if (dwarf2_per_objfile)
       {
 
+	char *filename = concat (arg, SLASH_STRING,
+				 lbasename (objfile_name (objfile)),
+				 INDEX_SUFFIX, (char *) NULL);
+	struct cleanup *cleanup = make_cleanup (xfree, filename);
+
 	TRY
 	  {
-	    write_psymtabs_to_index (objfile, arg);
+	    write_psymtabs_to_index (objfile, filename);
 	  }
 	CATCH (except, RETURN_MASK_ERROR)
 	  {
@@ -23499,6 +23767,8 @@ save_gdb_index_command (char *arg, int from_tty)
 			       objfile_name (objfile));
 	  }
 	END_CATCH
+
+	do_cleanups (cleanup);
       }
   }
 }
@@ -432,10 +432,108 @@ add_to_section_table (bfd *abfd, struct bfd_section *asect,
 void
 clear_section_table (struct target_section_table *table)
 {
+  section_table_invalidate (table);
   xfree (table->sections);
   table->sections = table->sections_end = NULL;
 }
 
+/* See exec.h.  */
+
+void
+section_table_invalidate (struct target_section_table *table)
+{
+  xfree (table->sorted);
+  table->sorted = NULL;
+  xfree (table->max_endaddr);
+  table->max_endaddr = NULL;
+}
+
+/* qsort comparison function for pointers to target sections, ordering
+   them by address, and then by position in their table.  */
+
+static int
+compare_target_section_ptrs (const void *a, const void *b)
+{
+  const struct target_section *sa = *(struct target_section * const *) a;
+  const struct target_section *sb = *(struct target_section * const *) b;
+
+  if (sa->addr != sb->addr)
+    return sa->addr < sb->addr ? -1 : 1;
+  if (sa != sb)
+    return sa < sb ? -1 : 1;
+  return 0;
+}
+
+/* Build the address index of TABLE.  */
+
+static void
+build_section_table_index (struct target_section_table *table)
+{
+  int count = table->sections_end - table->sections;
+  CORE_ADDR max_endaddr = 0;
+  int i;
+
+  table->sorted = XNEWVEC (struct target_section *, count);
+  table->max_endaddr = XNEWVEC (CORE_ADDR, count);
+
+  for (i = 0; i < count; i++)
+    table->sorted[i] = &table->sections[i];
+  qsort (table->sorted, count, sizeof (struct target_section *),
+	 compare_target_section_ptrs);
+
+  for (i = 0; i < count; i++)
+    {
+      if (table->sorted[i]->endaddr > max_endaddr)
+	max_endaddr = table->sorted[i]->endaddr;
+      table->max_endaddr[i] = max_endaddr;
+    }
+}
+
+/* See exec.h.  */
+
+struct target_section *
+section_table_find (struct target_section_table *table, CORE_ADDR addr,
+		    const char *section_name)
+{
+  struct target_section *best = NULL;
+  int lo, hi;
+
+  if (table->sections == table->sections_end)
+    return NULL;
+
+  if (table->sorted == NULL)
+    build_section_table_index (table);
+
+  /* Find the number of sections starting at or below ADDR.  */
+  lo = 0;
+  hi = table->sections_end - table->sections;
+  while (lo < hi)
+    {
+      int mid = lo + (hi - lo) / 2;
+
+      if (table->sorted[mid]->addr <= addr)
+	lo = mid + 1;
+      else
+	hi = mid;
+    }
+
+  /* Walk back through the sections starting at or below ADDR, as long
+     as one of them may still extend past ADDR.  Sections normally
+     don't overlap, so this usually looks at a single section.  */
+  for (hi = lo - 1; hi >= 0 && table->max_endaddr[hi] > addr; hi--)
+    {
+      struct target_section *p = table->sorted[hi];
+
+      if (addr < p->endaddr
+	  && (section_name == NULL
+	      || strcmp (section_name, p->the_bfd_section->name) == 0)
+	  && (best == NULL || p < best))
+	best = p;
+    }
+
+  return best;
+}
+
 /* Resize section table TABLE by ADJUSTMENT.
    ADJUSTMENT may be negative, in which case the caller must have already
    removed the sections being deleted.
@@ -451,6 +549,8 @@ resize_section_table (struct target_section_table *table, int adjustment)
 
   new_count = adjustment + old_count;
 
+  section_table_invalidate (table);
+
   if (new_count)
     {
       table->sections = XRESIZEVEC (struct target_section, table->sections,
@@ -754,77 +854,48 @@ enum target_xfer_status
 section_table_xfer_memory_partial (gdb_byte *readbuf, const gdb_byte *writebuf,
 				   ULONGEST offset, ULONGEST len,
 				   ULONGEST *xfered_len,
-				   struct target_section *sections,
-				   struct target_section *sections_end,
+				   struct target_section_table *table,
 				   const char *section_name)
 {
   int res;
   struct target_section *p;
   ULONGEST memaddr = offset;
   ULONGEST memend = memaddr + len;
+  struct bfd_section *asect;
+  bfd *abfd;
 
   if (len == 0)
     internal_error (__FILE__, __LINE__,
 		    _("failed internal consistency check"));
 
-  for (p = sections; p < sections_end; p++)
-    {
-      struct bfd_section *asect = p->the_bfd_section;
-      bfd *abfd = asect->owner;
-
-      if (section_name && strcmp (section_name, asect->name) != 0)
-	continue;		/* not the section we need.  */
-      if (memaddr >= p->addr)
-        {
-	  if (memend <= p->endaddr)
-	    {
-	      /* Entire transfer is within this section.  */
-	      if (writebuf)
-		res = bfd_set_section_contents (abfd, asect,
-						writebuf, memaddr - p->addr,
-						len);
-	      else
-		res = bfd_get_section_contents (abfd, asect,
-						readbuf, memaddr - p->addr,
-						len);
+  p = section_table_find (table, memaddr, section_name);
+  if (p == NULL)
+    return TARGET_XFER_EOF;		/* We can't help.  */
 
-	      if (res != 0)
-		{
-		  *xfered_len = len;
-		  return TARGET_XFER_OK;
-		}
-	      else
-		return TARGET_XFER_EOF;
-	    }
-	  else if (memaddr >= p->endaddr)
-	    {
-	      /* This section ends before the transfer starts.  */
-	      continue;
-	    }
-	  else
-	    {
-	      /* This section overlaps the transfer.  Just do half.  */
-	      len = p->endaddr - memaddr;
-	      if (writebuf)
-		res = bfd_set_section_contents (abfd, asect,
-						writebuf, memaddr - p->addr,
-						len);
-	      else
-		res = bfd_get_section_contents (abfd, asect,
-						readbuf, memaddr - p->addr,
-						len);
-	      if (res != 0)
-		{
-		  *xfered_len = len;
-		  return TARGET_XFER_OK;
-		}
-	      else
-		return TARGET_XFER_EOF;
-	    }
-        }
-    }
+  asect = p->the_bfd_section;
+  abfd = asect->owner;
+
+  /* If the section only overlaps the start of the transfer, just do
+     that part.  */
+  if (memend > p->endaddr)
+    len = p->endaddr - memaddr;
+
+  if (writebuf)
+    res = bfd_set_section_contents (abfd, asect,
+				    writebuf, memaddr - p->addr,
+				    len);
+  else
+    res = bfd_get_section_contents (abfd, asect,
+				    readbuf, memaddr - p->addr,
+				    len);
 
-  return TARGET_XFER_EOF;		/* We can't help.  */
+  if (res != 0)
+    {
+      *xfered_len = len;
+      return TARGET_XFER_OK;
+    }
+  else
+    return TARGET_XFER_EOF;
 }
 
 static struct target_section_table *
@@ -844,9 +915,7 @@ exec_xfer_partial (struct target_ops *ops, enum target_object object,
   if (object == TARGET_OBJECT_MEMORY)
     return section_table_xfer_memory_partial (readbuf, writebuf,
 					      offset, len, xfered_len,
-					      table->sections,
-					      table->sections_end,
-					      NULL);
+					      table, NULL);
   else
     return TARGET_XFER_E_IO;
 }
@@ -961,6 +1030,7 @@ set_section_command (char *args, int from_tty)
 	  offset = secaddr - p->addr;
 	  p->addr += offset;
 	  p->endaddr += offset;
+	  section_table_invalidate (table);
 	  if (from_tty)
 	    exec_files_info (&exec_ops);
 	  return;
@@ -992,6 +1062,7 @@ exec_set_section_address (const char *filename, int index, CORE_ADDR address)
 	  p->addr = address;
 	}
     }
+  section_table_invalidate (table);
 }
 
 /* If mourn is being called in all the right places, this could be say
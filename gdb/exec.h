@@ -43,6 +43,21 @@ extern int build_section_table (struct bfd *, struct target_section **,
 
 extern void clear_section_table (struct target_section_table *table);
 
+/* Discard the address index of TABLE.  This must be called whenever
+   the sections of TABLE, or their addresses, are changed.  */
+
+extern void section_table_invalidate (struct target_section_table *table);
+
+/* Return the section of TABLE containing ADDR, or NULL if there is
+   none.  If SECTION_NAME is not NULL, only consider sections with
+   that name.  If several sections contain ADDR, return the first one
+   in TABLE.  This uses a sorted index of TABLE, built on first
+   use.  */
+
+extern struct target_section *
+  section_table_find (struct target_section_table *table, CORE_ADDR addr,
+		      const char *section_name);
+
 /* Read from mappable read-only sections of BFD executable files.
    Return TARGET_XFER_OK, if read is successful.  Return
    TARGET_XFER_EOF if read is done.  Return TARGET_XFER_E_IO
@@ -55,8 +70,7 @@ extern enum target_xfer_status
 /* Read or write from mappable sections of BFD executable files.
 
    Request to transfer up to LEN 8-bit bytes of the target sections
-   defined by SECTIONS and SECTIONS_END.  The OFFSET specifies the
-   starting address.
+   of TABLE.  The OFFSET specifies the starting address.
    If SECTION_NAME is not NULL, only access sections with that same
    name.
 
@@ -73,8 +87,7 @@ extern enum target_xfer_status
   section_table_xfer_memory_partial (gdb_byte *,
 				     const gdb_byte *,
 				     ULONGEST, ULONGEST, ULONGEST *,
-				     struct target_section *,
-				     struct target_section *,
+				     struct target_section_table *,
 				     const char *);
 
 /* Read from mappable read-only sections of BFD executable files.
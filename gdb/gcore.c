@@ -29,6 +29,7 @@
 #include "completer.h"
 #include "gcore.h"
 #include "cli/cli-decode.h"
+#include "gdbcmd.h"
 #include <fcntl.h>
 #include "regcache.h"
 #include "regset.h"
@@ -40,6 +41,14 @@
    generate-core-file for programs with large resident data.  */
 #define MAX_COPY_BYTES (1024 * 1024)
 
+/* The granularity at which memory that can't be read is skipped, and
+   at which all-zero memory is left out of the core file.  */
+#define GCORE_PAGE_SIZE 4096
+
+/* Whether generate-core-file leaves all-zero pages out of the core
+   file, as holes in a sparse file.  */
+static int gcore_sparse = 1;
+
 static const char *default_gcore_target (void);
 static enum bfd_architecture default_gcore_arch (void);
 static unsigned long default_gcore_mach (void);
@@ -556,13 +565,178 @@ objfile_find_memory_regions (struct target_ops *self,
   return 0;
 }
 
+/* A part of a load section to be copied to the core file.  */
+
+struct gcore_copy_piece
+{
+  /* The section being copied.  */
+  asection *osec;
+
+  /* The offset of this part in OSEC.  */
+  file_ptr offset;
+};
+
+/* The state of copying memory into the core file.  Parts of the load
+   sections are queued until MAX_COPY_BYTES worth of them, or
+   GCORE_MAX_PIECES of them, are pending, and are then read from the
+   target together.  */
+
+#define GCORE_MAX_PIECES (MAX_COPY_BYTES / GCORE_PAGE_SIZE)
+
+struct gcore_copy_data
+{
+  /* The core file being written.  */
+  bfd *obfd;
+
+  /* The buffer the pending reads go to.  */
+  gdb_byte *buf;
+
+  /* The number of bytes of BUF in use.  */
+  ULONGEST used;
+
+  /* The pending pieces and their read requests.  */
+  struct gcore_copy_piece pieces[GCORE_MAX_PIECES];
+  struct memory_read_request requests[GCORE_MAX_PIECES];
+  int count;
+};
+
+/* Return non-zero if the LEN bytes at BUF are all zero.  */
+
+static int
+gcore_zero_memory_p (const gdb_byte *buf, ULONGEST len)
+{
+  return len == 0 || (buf[0] == 0 && memcmp (buf, buf + 1, len - 1) == 0);
+}
+
+/* Read the memory of REQ, which could not be read in one go, a page
+   at a time.  Pages that can't be read are left as zeros.  */
+
 static void
-gcore_copy_callback (bfd *obfd, asection *osec, void *ignored)
+gcore_read_by_page (struct memory_read_request *req)
 {
-  bfd_size_type size, total_size = bfd_section_size (obfd, osec);
+  ULONGEST pos, len;
+  ULONGEST failed = 0;
+  CORE_ADDR first_failed = 0;
+
+  for (pos = 0; pos < req->len; pos += len)
+    {
+      /* Stop at the page boundaries of the target's address space,
+	 not of the piece.  */
+      len = GCORE_PAGE_SIZE - (req->addr + pos) % GCORE_PAGE_SIZE;
+      if (len > req->len - pos)
+	len = req->len - pos;
+
+      if (target_read_memory (req->addr + pos, req->buf + pos, len) != 0)
+	{
+	  memset (req->buf + pos, 0, len);
+	  if (failed == 0)
+	    first_failed = req->addr + pos;
+	  failed += len;
+	}
+    }
+
+  if (failed != 0)
+    warning (_("Memory read failed for corefile "
+	       "section, %s bytes at %s."),
+	     plongest (failed),
+	     paddress (target_gdbarch (), first_failed));
+}
+
+/* Write the data read for PIECE to the core file.  With gcore_sparse
+   on, runs of all-zero pages are skipped, leaving holes in the file
+   that read back as zeros.  The end of each section is always
+   written, so that the file is not cut short.  Return zero on
+   failure.  */
+
+static int
+gcore_write_piece (bfd *obfd, struct gcore_copy_piece *piece,
+		   struct memory_read_request *req)
+{
+  bfd_size_type section_size = bfd_section_size (obfd, piece->osec);
+  ULONGEST pos = 0;
+
+  while (pos < req->len)
+    {
+      ULONGEST start, len;
+
+      /* Skip the zero pages.  */
+      if (gcore_sparse)
+	while (pos < req->len)
+	  {
+	    len = GCORE_PAGE_SIZE - (req->addr + pos) % GCORE_PAGE_SIZE;
+	    if (len > req->len - pos)
+	      len = req->len - pos;
+	    if (piece->offset + pos + len == section_size
+		|| !gcore_zero_memory_p (req->buf + pos, len))
+	      break;
+	    pos += len;
+	  }
+
+      /* Then write the pages that follow, up to the next zero page.  */
+      start = pos;
+      while (pos < req->len)
+	{
+	  len = GCORE_PAGE_SIZE - (req->addr + pos) % GCORE_PAGE_SIZE;
+	  if (len > req->len - pos)
+	    len = req->len - pos;
+	  if (gcore_sparse
+	      && pos > start
+	      && piece->offset + pos + len != section_size
+	      && gcore_zero_memory_p (req->buf + pos, len))
+	    break;
+	  pos += len;
+	}
+
+      if (pos > start
+	  && !bfd_set_section_contents (obfd, piece->osec, req->buf + start,
+					piece->offset + start, pos - start))
+	{
+	  warning (_("Failed to write corefile contents (%s)."),
+		   bfd_errmsg (bfd_get_error ()));
+	  return 0;
+	}
+    }
+
+  return 1;
+}
+
+/* Read the pending pieces of DATA from the target, and write them to
+   the core file.  */
+
+static void
+gcore_flush_pieces (struct gcore_copy_data *data)
+{
+  int i;
+
+  if (data->count == 0)
+    return;
+
+  /* One batch lets targets that can read many blocks at once, such
+     as native GNU/Linux with process_vm_readv, do so.  */
+  target_read_memory_batch (data->requests, data->count);
+
+  for (i = 0; i < data->count; i++)
+    {
+      struct gcore_copy_piece *piece = &data->pieces[i];
+      struct memory_read_request *req = &data->requests[i];
+
+      if (req->status != TARGET_XFER_OK)
+	gcore_read_by_page (req);
+
+      if (!gcore_write_piece (data->obfd, piece, req))
+	break;
+    }
+
+  data->count = 0;
+  data->used = 0;
+}
+
+static void
+gcore_copy_callback (bfd *obfd, asection *osec, void *arg)
+{
+  struct gcore_copy_data *data = (struct gcore_copy_data *) arg;
+  bfd_size_type total_size = bfd_section_size (obfd, osec);
   file_ptr offset = 0;
-  struct cleanup *old_chain = NULL;
-  gdb_byte *memhunk;
 
   /* Read-only sections are marked; we don't have to copy their contents.  */
   if ((bfd_get_section_flags (obfd, osec) & SEC_LOAD) == 0)
@@ -572,41 +746,36 @@ gcore_copy_callback (bfd *obfd, asection *osec, void *ignored)
   if (!startswith (bfd_section_name (obfd, osec), "load"))
     return;
 
-  size = min (total_size, MAX_COPY_BYTES);
-  memhunk = (gdb_byte *) xmalloc (size);
-  old_chain = make_cleanup (xfree, memhunk);
-
   while (total_size > 0)
     {
-      if (size > total_size)
-	size = total_size;
+      struct memory_read_request *req;
+      bfd_size_type size;
 
-      if (target_read_memory (bfd_section_vma (obfd, osec) + offset,
-			      memhunk, size) != 0)
-	{
-	  warning (_("Memory read failed for corefile "
-		     "section, %s bytes at %s."),
-		   plongest (size),
-		   paddress (target_gdbarch (), bfd_section_vma (obfd, osec)));
-	  break;
-	}
-      if (!bfd_set_section_contents (obfd, osec, memhunk, offset, size))
-	{
-	  warning (_("Failed to write corefile contents (%s)."),
-		   bfd_errmsg (bfd_get_error ()));
-	  break;
-	}
+      if (data->count == GCORE_MAX_PIECES || data->used == MAX_COPY_BYTES)
+	gcore_flush_pieces (data);
+
+      size = min (total_size, MAX_COPY_BYTES - data->used);
+
+      data->pieces[data->count].osec = osec;
+      data->pieces[data->count].offset = offset;
+      req = &data->requests[data->count];
+      req->addr = bfd_section_vma (obfd, osec) + offset;
+      req->len = size;
+      req->buf = data->buf + data->used;
+      data->count++;
+      data->used += size;
 
       total_size -= size;
       offset += size;
     }
-
-  do_cleanups (old_chain);	/* Frees MEMHUNK.  */
 }
 
 static int
 gcore_memory_sections (bfd *obfd)
 {
+  struct gcore_copy_data *data;
+  struct cleanup *cleanup;
+
   /* Try gdbarch method first, then fall back to target method.  */
   if (!gdbarch_find_memory_regions_p (target_gdbarch ())
       || gdbarch_find_memory_regions (target_gdbarch (),
@@ -620,11 +789,29 @@ gcore_memory_sections (bfd *obfd)
   bfd_map_over_sections (obfd, make_output_phdrs, NULL);
 
   /* Copy memory region contents.  */
-  bfd_map_over_sections (obfd, gcore_copy_callback, NULL);
+  data = XCNEW (struct gcore_copy_data);
+  cleanup = make_cleanup (xfree, data);
+  data->obfd = obfd;
+  data->buf = (gdb_byte *) xmalloc (MAX_COPY_BYTES);
+  make_cleanup (xfree, data->buf);
+
+  bfd_map_over_sections (obfd, gcore_copy_callback, data);
+  gcore_flush_pieces (data);
 
+  do_cleanups (cleanup);
   return 1;
 }
 
+/* Implement "show gcore-sparse".  */
+
+static void
+show_gcore_sparse (struct ui_file *file, int from_tty,
+		   struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file, _("Leaving all-zero memory out of core files "
+			    "is %s.\n"), value);
+}
+
 /* Provide a prototype to silence -Wmissing-prototypes.  */
 extern initialize_file_ftype _initialize_gcore;
 
@@ -636,4 +823,14 @@ Save a core file with the current state of the debugged process.\n\
 Argument is optional filename.  Default filename is 'core.<process_id>'."));
 
   add_com_alias ("gcore", "generate-core-file", class_files, 1);
+
+  add_setshow_boolean_cmd ("gcore-sparse", class_files,
+			   &gcore_sparse, _("\
+Set whether gcore leaves all-zero memory out of the core file."), _("\
+Show whether gcore leaves all-zero memory out of the core file."), _("\
+When on, pages of memory that only hold zeros are not written to the\n\
+core file, which is then sparse on file systems that support it.\n\
+Reading the core file gives the same result either way."),
+			   NULL, show_gcore_sparse,
+			   &setlist, &showlist);
 }
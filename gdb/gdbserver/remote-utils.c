@@ -57,6 +57,9 @@
 #include <arpa/inet.h>
 #endif
 #include <sys/stat.h>
+#ifdef HAVE_LIBZ
+#include <zlib.h>
+#endif
 
 #if USE_WIN32API
 #include <winsock2.h>
@@ -114,6 +117,8 @@ extern int debug_threads;
 
 /* If true, then GDB has requested noack mode.  */
 int noack_mode = 0;
+/* If true, then GDB has requested packet compression.  */
+int compress_packets = 0;
 /* If true, then we tell GDB to use noack mode by default.  */
 int transport_is_reliable = 0;
 
@@ -609,6 +614,96 @@ read_prim (void *buf, int count)
     return read (remote_desc, buf, count);
 }
 
+/* If GDB requested packet compression and the CNT bytes of packet
+   data in BUF shrink when compressed, return a newly allocated buffer
+   holding the compressed packet data, and store its length in
+   *OUT_LEN.  Otherwise, return NULL.  */
+
+static char *
+compress_packet (const char *buf, int cnt, int *out_len)
+{
+#ifdef HAVE_LIBZ
+  gdb_byte *zbuf;
+  uLongf zlen;
+  char *out;
+  int header_len, len, units;
+
+  if (!compress_packets || cnt < RSP_COMPRESS_THRESHOLD)
+    return NULL;
+
+  zlen = compressBound (cnt);
+  zbuf = (gdb_byte *) xmalloc (zlen);
+  if (compress2 (zbuf, &zlen, (const Bytef *) buf, cnt,
+		 Z_BEST_SPEED) != Z_OK)
+    {
+      free (zbuf);
+      return NULL;
+    }
+
+  out = (char *) xmalloc (cnt);
+  header_len = sprintf (out, "%c%x:", RSP_COMPRESSED_PACKET_MARKER, cnt);
+  len = remote_escape_output (zbuf, zlen, 1, (gdb_byte *) out + header_len,
+			      &units, cnt - header_len - 1);
+  free (zbuf);
+  if (units < (int) zlen)
+    {
+      free (out);
+      return NULL;
+    }
+
+  if (remote_debug)
+    {
+      fprintf (stderr, "[compressed packet: %d bytes to %d]\n",
+	       cnt, header_len + len);
+      fflush (stderr);
+    }
+
+  *out_len = header_len + len;
+  return out;
+#else
+  return NULL;
+#endif
+}
+
+/* If the LEN bytes of packet data in BUF, a buffer of PBUFSIZ + 1
+   bytes, are a compressed packet, replace them with the uncompressed
+   data.  Return the length of the resulting packet data, or -1 if it
+   could not be decompressed.  */
+
+static int
+decompress_packet (char *buf, int len)
+{
+#ifdef HAVE_LIBZ
+  ULONGEST raw_len;
+  uLongf out_len;
+  gdb_byte *zbuf;
+  char *p;
+  int zlen, status;
+
+  if (!compress_packets || len == 0
+      || buf[0] != RSP_COMPRESSED_PACKET_MARKER)
+    return len;
+
+  p = unpack_varlen_hex (buf + 1, &raw_len);
+  if (*p != ':' || raw_len == 0 || raw_len > PBUFSIZ)
+    return -1;
+  p++;
+
+  zbuf = (gdb_byte *) xmalloc (len);
+  zlen = remote_unescape_input ((gdb_byte *) p, len - (p - buf), zbuf, len);
+  out_len = raw_len;
+  status = uncompress ((Bytef *) buf, &out_len, zbuf, zlen);
+  free (zbuf);
+  if (status != Z_OK || out_len != raw_len)
+    return -1;
+
+  buf[raw_len] = '\0';
+  return raw_len;
+#else
+  return len;
+#endif
+}
+
 /* Send a packet to the remote machine, with error checking.
    The data of the packet is in BUF, and the length of the
    packet is in CNT.  Returns >= 0 on success, -1 otherwise.  */
@@ -621,6 +716,17 @@ putpkt_binary_1 (char *buf, int cnt, int is_notif)
   char *buf2;
   char *p;
   int cc;
+  char *zbuf = NULL;
+  int zcnt;
+
+  /* Send large packets compressed, if GDB asked for that.  */
+  if (!is_notif)
+    zbuf = compress_packet (buf, cnt, &zcnt);
+  if (zbuf != NULL)
+    {
+      buf = zbuf;
+      cnt = zcnt;
+    }
 
   buf2 = (char *) xmalloc (strlen ("$") + cnt + strlen ("#nn") + 1);
 
@@ -650,6 +756,7 @@ putpkt_binary_1 (char *buf, int cnt, int is_notif)
 	{
 	  perror ("putpkt(write)");
 	  free (buf2);
+	  free (zbuf);
 	  return -1;
 	}
 
@@ -678,6 +785,7 @@ putpkt_binary_1 (char *buf, int cnt, int is_notif)
       if (cc < 0)
 	{
 	  free (buf2);
+	  free (zbuf);
 	  return -1;
 	}
 
@@ -694,6 +802,7 @@ putpkt_binary_1 (char *buf, int cnt, int is_notif)
   while (cc != '+');
 
   free (buf2);
+  free (zbuf);
   return 1;			/* Success! */
 }
 
@@ -947,7 +1056,7 @@ getpkt (char *buf)
 {
   char *bp;
   unsigned char csum, c1, c2;
-  int c;
+  int c, len;
 
   while (1)
     {
@@ -1029,7 +1138,11 @@ getpkt (char *buf)
 	}
     }
 
-  return bp - buf;
+  len = decompress_packet (buf, bp - buf);
+  if (len < 0)
+    fprintf (stderr, "Could not decompress packet from GDB\n");
+
+  return len;
 }
 
 void
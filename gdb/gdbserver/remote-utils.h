@@ -21,6 +21,7 @@
 
 extern int remote_debug;
 extern int noack_mode;
+extern int compress_packets;
 extern int transport_is_reliable;
 
 int gdb_connected (void);
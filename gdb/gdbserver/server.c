@@ -632,6 +632,23 @@ handle_general_set (char *own_buf)
       return;
     }
 
+#ifdef HAVE_LIBZ
+  if (strcmp (own_buf, "QCompressPackets") == 0)
+    {
+      if (remote_debug)
+	{
+	  fprintf (stderr, "[packet compression enabled]\n");
+	  fflush (stderr);
+	}
+
+      /* The OK reply is too short to be compressed, so GDB reads it
+	 correctly whether or not it knows about compression yet.  */
+      compress_packets = 1;
+      write_ok (own_buf);
+      return;
+    }
+#endif
+
   if (startswith (own_buf, "QNonStop:"))
     {
       char *mode = own_buf + 9;
@@ -2236,6 +2253,12 @@ handle_query (char *own_buf, int packet_len, int *new_packet_len_p)
 
       strcat (own_buf, ";vContSupported+");
 
+      strcat (own_buf, ";vReadMem+");
+
+#ifdef HAVE_LIBZ
+      strcat (own_buf, ";QCompressPackets+");
+#endif
+
       /* Reinitialize components as needed for the new connection.  */
       hostio_handle_new_gdb_connection ();
       target_handle_new_gdb_connection ();
@@ -2820,6 +2843,66 @@ handle_v_kill (char *own_buf)
     }
 }
 
+/* Handle a "vReadMem:ADDR,LENGTH[;ADDR,LENGTH]..." packet.  Read each
+   range and reply with the contents of as many of them as fit in the
+   packet buffer, in order, each as the hex number of bytes read, a
+   colon, and the bytes in escaped binary.  A length of zero means the
+   memory at ADDR could not be read; a length less than LENGTH means
+   only that much could be read, or fit.  */
+
+static void
+handle_v_read_mem (char *own_buf, int *new_packet_len)
+{
+  char *ranges = xstrdup (own_buf + strlen ("vReadMem:"));
+  unsigned char *escaped = (unsigned char *) xmalloc (PBUFSIZ);
+  int out_max = PBUFSIZ - 2;
+  int out_len = 0;
+  char *p = ranges;
+
+  while (*p != '\0')
+    {
+      ULONGEST addr, len;
+      int room, res, used, units;
+
+      p = unpack_varlen_hex (p, &addr);
+      if (*p++ != ',')
+	{
+	  write_enn (own_buf);
+	  goto out;
+	}
+      p = unpack_varlen_hex (p, &len);
+      if (*p == ';')
+	p++;
+      else if (*p != '\0' || len == 0)
+	{
+	  write_enn (own_buf);
+	  goto out;
+	}
+
+      /* Stop once not even one more byte would fit.  */
+      room = out_max - out_len - (2 * sizeof (ULONGEST) + 1);
+      if (room <= 0)
+	break;
+
+      if (len > room)
+	len = room;
+      res = gdb_read_memory (addr, mem_buf, len);
+      if (res < 0)
+	res = 0;
+
+      used = remote_escape_output (mem_buf, res, 1, escaped, &units, room);
+      out_len += sprintf (own_buf + out_len, "%x:", units);
+      memcpy (own_buf + out_len, escaped, used);
+      out_len += used;
+    }
+
+  *new_packet_len = out_len;
+
+ out:
+  free (escaped);
+  free (ranges);
+}
+
 /* Handle all of the extended 'v' packets.  */
 void
 handle_v_requests (char *own_buf, int packet_len, int *new_packet_len)
@@ -2884,6 +2967,13 @@ handle_v_requests (char *own_buf, int packet_len, int *new_packet_len)
       return;
     }
 
+  if (startswith (own_buf, "vReadMem:"))
+    {
+      require_running (own_buf);
+      handle_v_read_mem (own_buf, new_packet_len);
+      return;
+    }
+
   if (startswith (own_buf, "vKill;"))
     {
       if (!target_running ())
@@ -3578,6 +3668,7 @@ captured_main (int argc, char *argv[])
     {
 
       noack_mode = 0;
+      compress_packets = 0;
       multi_process = 0;
       report_fork_events = 0;
       report_vfork_events = 0;
@@ -184,6 +184,20 @@ typedef VEC (value_ptr) value_vec;
 struct thread_info
 {
   struct thread_info *next;
+
+  /* The previous thread in THREAD_LIST.  */
+  struct thread_info *prev;
+
+  /* The next and previous threads of the same process, most recently
+     added first.  See ALL_THREADS_OF_PROCESS.  */
+  struct thread_info *next_in_process;
+  struct thread_info *prev_in_process;
+
+  /* The next older thread with the same ptid in the ptid hash table.
+     A thread that could not be deleted right away may share its ptid
+     with a newer thread.  */
+  struct thread_info *next_same_ptid;
+
   ptid_t ptid;			/* "Actual process id";
 				    In fact, this may be overloaded with 
 				    kernel thread id, etc.  */
@@ -409,6 +423,17 @@ extern struct thread_info *iterate_over_threads (thread_callback_func, void *);
        (T) != NULL ? ((TMP) = (T)->next, 1): 0;	\
        (T) = (TMP))
 
+/* Return the most recently added thread of process PID, or NULL if
+   there is none.  */
+extern struct thread_info *process_thread_list (int pid);
+
+/* Traverse the threads of process PID, including those that have
+   THREAD_EXITED state, without visiting the threads of other
+   processes.  */
+
+#define ALL_THREADS_OF_PROCESS(PID, T)		\
+  for (T = process_thread_list (PID); T; T = T->next_in_process)
+
 extern int thread_count (void);
 
 /* Switch from one thread to another.  */
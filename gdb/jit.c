@@ -52,6 +52,8 @@ static const struct program_space_data *jit_program_space_data = NULL;
 
 static void jit_inferior_init (struct gdbarch *gdbarch);
 
+static struct jit_program_space_data *get_jit_program_space_data (void);
+
 /* An unwinder is registered for every gdbarch.  This key is used to
    remember if the unwinder has been registered for a particular
    gdbarch.  */
@@ -256,6 +258,26 @@ struct jit_program_space_data
      set.  */
 
   struct breakpoint *jit_breakpoint;
+
+  /* The code entries seen so far, as struct jit_entry hashed by
+     address, so that registering and unregistering code does not
+     need to walk all the objfiles.  NULL until an entry is seen.  */
+
+  htab_t entries;
+};
+
+/* An element of jit_program_space_data.entries.  */
+
+struct jit_entry
+{
+  /* The address of the struct jit_code_entry in the inferior.  */
+
+  CORE_ADDR addr;
+
+  /* The objfile created for the entry, or NULL if its symbols could
+     not be read.  */
+
+  struct objfile *objfile;
 };
 
 /* Per-objfile structure recording the addresses in the program space.
@@ -295,6 +317,80 @@ get_jit_objfile_data (struct objfile *objf)
   return objf_data;
 }
 
+/* Hash function for struct jit_entry.  */
+
+static hashval_t
+hash_jit_entry (const void *p)
+{
+  const struct jit_entry *entry = (const struct jit_entry *) p;
+
+  return iterative_hash (&entry->addr, sizeof (entry->addr), 0);
+}
+
+/* Equality function for struct jit_entry.  */
+
+static int
+eq_jit_entry (const void *a, const void *b)
+{
+  const struct jit_entry *ea = (const struct jit_entry *) a;
+  const struct jit_entry *eb = (const struct jit_entry *) b;
+
+  return ea->addr == eb->addr;
+}
+
+/* Return the entry of PS_DATA for the struct jit_code_entry at inferior
+   address ADDR, or NULL if it was not seen.  */
+
+static struct jit_entry *
+jit_find_entry (struct jit_program_space_data *ps_data, CORE_ADDR addr)
+{
+  struct jit_entry entry;
+
+  if (ps_data->entries == NULL)
+    return NULL;
+
+  entry.addr = addr;
+  return (struct jit_entry *) htab_find (ps_data->entries, &entry);
+}
+
+/* Record in PS_DATA that the struct jit_code_entry at inferior
+   address ADDR was seen, and that OBJFILE, if not NULL, holds its
+   symbols.  */
+
+static void
+jit_record_entry (struct jit_program_space_data *ps_data, CORE_ADDR addr,
+		  struct objfile *objfile)
+{
+  struct jit_entry entry, **slot;
+
+  if (ps_data->entries == NULL)
+    ps_data->entries = htab_create_alloc (1, hash_jit_entry, eq_jit_entry,
+					  xfree, xcalloc, xfree);
+
+  entry.addr = addr;
+  slot = (struct jit_entry **) htab_find_slot (ps_data->entries, &entry,
+					       INSERT);
+  if (*slot == NULL)
+    *slot = XNEW (struct jit_entry);
+  (*slot)->addr = addr;
+  (*slot)->objfile = objfile;
+}
+
+/* Forget the struct jit_code_entry at inferior address ADDR in
+   PS_DATA.  */
+
+static void
+jit_forget_entry (struct jit_program_space_data *ps_data, CORE_ADDR addr)
+{
+  struct jit_entry entry;
+
+  if (ps_data->entries == NULL)
+    return;
+
+  entry.addr = addr;
+  htab_remove_elt (ps_data->entries, &entry);
+}
+
 /* Remember OBJFILE has been created for struct jit_code_entry located
    at inferior address ENTRY.  */
 
@@ -305,6 +401,7 @@ add_objfile_entry (struct objfile *objfile, CORE_ADDR entry)
 
   objf_data = get_jit_objfile_data (objfile);
   objf_data->addr = entry;
+  jit_record_entry (get_jit_program_space_data (), entry, objfile);
 }
 
 /* Return jit_program_space_data for current program space.  Allocate
@@ -331,7 +428,12 @@ get_jit_program_space_data (void)
 static void
 jit_program_space_data_cleanup (struct program_space *ps, void *arg)
 {
-  xfree (arg);
+  struct jit_program_space_data *ps_data
+    = (struct jit_program_space_data *) arg;
+
+  if (ps_data->entries != NULL)
+    htab_delete (ps_data->entries);
+  xfree (ps_data);
 }
 
 /* Helper function for reading the global JIT descriptor from remote
@@ -940,7 +1042,8 @@ JITed symbol file is not an object file, ignoring it.\n"));
 
   /* This call does not take ownership of SAI.  */
   make_cleanup_bfd_unref (nbfd);
-  objfile = symbol_file_add_from_bfd (nbfd, bfd_get_filename (nbfd), 0, sai,
+  objfile = symbol_file_add_from_bfd (nbfd, bfd_get_filename (nbfd),
+				      SYMFILE_DEFER_BP_RESET, sai,
 				      OBJF_SHARED | OBJF_NOT_FILENAME, NULL);
 
   do_cleanups (old_cleanups);
@@ -950,12 +1053,14 @@ JITed symbol file is not an object file, ignoring it.\n"));
 /* This function registers code associated with a JIT code entry.  It uses the
    pointer and size pair in the entry to read the symbol file from the remote
    and then calls symbol_file_add_from_local_memory to add it as though it were
-   a symbol file added by the user.  */
+   a symbol file added by the user.  Breakpoints are not re-set; callers
+   do that once they registered all the code they have to.  */
 
 static void
 jit_register_code (struct gdbarch *gdbarch,
                    CORE_ADDR entry_addr, struct jit_code_entry *code_entry)
 {
+  struct jit_program_space_data *ps_data = get_jit_program_space_data ();
   int success;
 
   if (jit_debug)
@@ -969,34 +1074,61 @@ jit_register_code (struct gdbarch *gdbarch,
 
   if (!success)
     jit_bfd_try_read_symtab (code_entry, entry_addr, gdbarch);
-}
 
-/* This function unregisters JITed code and frees the corresponding
-   objfile.  */
-
-static void
-jit_unregister_code (struct objfile *objfile)
-{
-  free_objfile (objfile);
+  /* Don't try again if the symbols could not be read.  */
+  if (jit_find_entry (ps_data, entry_addr) == NULL)
+    jit_record_entry (ps_data, entry_addr, NULL);
 }
 
-/* Look up the objfile with this code entry address.  */
+/* Register the code entries in the list of code entries starting at
+   FIRST that were not seen yet, up to the first one that was.  JITs
+   add new entries at the head of the list, so this registers all the
+   entries added since the last registration, even if the JIT only
+   reported one of them.  Then make sure the entry at RELEVANT, if not
+   zero, is registered too.  Re-set the breakpoints once at the end,
+   rather than for each entry.  */
 
-static struct objfile *
-jit_find_objf_with_entry_addr (CORE_ADDR entry_addr)
+static void
+jit_register_new_entries (struct gdbarch *gdbarch, CORE_ADDR first,
+			  CORE_ADDR relevant)
 {
-  struct objfile *objf;
+  struct jit_program_space_data *ps_data = get_jit_program_space_data ();
+  struct jit_code_entry code_entry;
+  CORE_ADDR addr;
+  int count = 0;
 
-  ALL_OBJFILES (objf)
+  for (addr = first;
+       addr != 0 && jit_find_entry (ps_data, addr) == NULL;
+       addr = code_entry.next_entry)
     {
-      struct jit_objfile_data *objf_data;
+      jit_read_code_entry (gdbarch, addr, &code_entry);
+      jit_register_code (gdbarch, addr, &code_entry);
+      count++;
+    }
 
-      objf_data
-	= (struct jit_objfile_data *) objfile_data (objf, jit_objfile_data);
-      if (objf_data != NULL && objf_data->addr == entry_addr)
-        return objf;
+  if (relevant != 0 && jit_find_entry (ps_data, relevant) == NULL)
+    {
+      jit_read_code_entry (gdbarch, relevant, &code_entry);
+      jit_register_code (gdbarch, relevant, &code_entry);
+      count++;
     }
-  return NULL;
+
+  if (jit_debug && count > 1)
+    fprintf_unfiltered (gdb_stdlog,
+			"jit_register_new_entries, registered %d entries\n",
+			count);
+
+  if (count > 0)
+    breakpoint_re_set ();
+}
+
+/* This function unregisters JITed code and frees the corresponding
+   objfile.  */
+
+static void
+jit_unregister_code (struct objfile *objfile)
+{
+  free_objfile (objfile);
 }
 
 /* This is called when a breakpoint is deleted.  It updates the
@@ -1325,6 +1457,7 @@ jit_inferior_init (struct gdbarch *gdbarch)
   struct jit_code_entry cur_entry;
   struct jit_program_space_data *ps_data;
   CORE_ADDR cur_entry_addr;
+  int count = 0;
 
   if (jit_debug)
     fprintf_unfiltered (gdb_stdlog, "jit_inferior_init\n");
@@ -1359,11 +1492,15 @@ jit_inferior_init (struct gdbarch *gdbarch)
 
       /* This hook may be called many times during setup, so make sure we don't
          add the same symbol file twice.  */
-      if (jit_find_objf_with_entry_addr (cur_entry_addr) != NULL)
+      if (jit_find_entry (ps_data, cur_entry_addr) != NULL)
         continue;
 
       jit_register_code (gdbarch, cur_entry_addr, &cur_entry);
+      count++;
     }
+
+  if (count > 0)
+    breakpoint_re_set ();
 }
 
 /* Exported routine to call when an inferior has been created.  */
@@ -1393,6 +1530,7 @@ jit_inferior_exit_hook (struct inferior *inf)
 {
   struct objfile *objf;
   struct objfile *temp;
+  struct jit_program_space_data *ps_data;
 
   ALL_OBJFILES_SAFE (objf, temp)
     {
@@ -1402,19 +1540,25 @@ jit_inferior_exit_hook (struct inferior *inf)
       if (objf_data != NULL && objf_data->addr != 0)
 	jit_unregister_code (objf);
     }
+
+  /* Also forget the entries whose symbols could not be read.  */
+  ps_data = ((struct jit_program_space_data *)
+	     program_space_data (inf->pspace, jit_program_space_data));
+  if (ps_data != NULL && ps_data->entries != NULL)
+    htab_empty (ps_data->entries);
 }
 
 void
 jit_event_handler (struct gdbarch *gdbarch)
 {
   struct jit_descriptor descriptor;
-  struct jit_code_entry code_entry;
+  struct jit_program_space_data *ps_data;
+  struct jit_entry *entry;
   CORE_ADDR entry_addr;
-  struct objfile *objf;
 
   /* Read the descriptor from remote memory.  */
-  if (!jit_read_descriptor (gdbarch, &descriptor,
-			    get_jit_program_space_data ()))
+  ps_data = get_jit_program_space_data ();
+  if (!jit_read_descriptor (gdbarch, &descriptor, ps_data))
     return;
   entry_addr = descriptor.relevant_entry;
 
@@ -1424,17 +1568,18 @@ jit_event_handler (struct gdbarch *gdbarch)
     case JIT_NOACTION:
       break;
     case JIT_REGISTER:
-      jit_read_code_entry (gdbarch, entry_addr, &code_entry);
-      jit_register_code (gdbarch, entry_addr, &code_entry);
+      jit_register_new_entries (gdbarch, descriptor.first_entry, entry_addr);
       break;
     case JIT_UNREGISTER:
-      objf = jit_find_objf_with_entry_addr (entry_addr);
-      if (objf == NULL)
+      entry = jit_find_entry (ps_data, entry_addr);
+      if (entry == NULL)
 	printf_unfiltered (_("Unable to find JITed code "
 			     "entry at address: %s\n"),
 			   paddress (gdbarch, entry_addr));
+      else if (entry->objfile != NULL)
+        jit_unregister_code (entry->objfile);
       else
-        jit_unregister_code (objf);
+	jit_forget_entry (ps_data, entry_addr);
 
       break;
     default:
@@ -1450,6 +1595,22 @@ free_objfile_data (struct objfile *objfile, void *data)
 {
   struct jit_objfile_data *objf_data = (struct jit_objfile_data *) data;
 
+  if (objf_data->addr != 0)
+    {
+      struct jit_program_space_data *ps_data;
+
+      ps_data
+	= ((struct jit_program_space_data *)
+	   program_space_data (objfile->pspace, jit_program_space_data));
+      if (ps_data != NULL)
+	{
+	  struct jit_entry *entry = jit_find_entry (ps_data, objf_data->addr);
+
+	  if (entry != NULL && entry->objfile == objfile)
+	    jit_forget_entry (ps_data, objf_data->addr);
+	}
+    }
+
   if (objf_data->register_code != NULL)
     {
       struct jit_program_space_data *ps_data;
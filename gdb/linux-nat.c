@@ -47,6 +47,7 @@
 #include "gdbcore.h"		/* for get_exec_file */
 #include <ctype.h>		/* for isdigit */
 #include <sys/stat.h>		/* for struct stat */
+#include <sys/uio.h>		/* for process_vm_readv */
 #include <fcntl.h>		/* for O_RDONLY */
 #include "inf-loop.h"
 #include "event-loop.h"
@@ -68,6 +69,9 @@
 #include "objfiles.h"
 #include "nat/linux-namespaces.h"
 #include "fileio.h"
+#include "ax.h"
+#include "gdb_sys_time.h"
+#include "timeval-utils.h"
 
 #ifndef SPUFS_MAGIC
 #define SPUFS_MAGIC 0x23c9b64e
@@ -201,6 +205,27 @@ static target_xfer_partial_ftype *super_xfer_partial;
    Called by our to_close.  */
 static void (*super_close) (struct target_ops *);
 
+/* The saved to_insert_breakpoint and to_remove_breakpoint methods,
+   inherited from inf-child.c.  Called by ours, which additionally
+   keep track of the inserted breakpoints so that their target-side
+   conditions can be evaluated when they are hit.  */
+static int (*super_insert_breakpoint) (struct target_ops *,
+				       struct gdbarch *,
+				       struct bp_target_info *);
+static int (*super_remove_breakpoint) (struct target_ops *,
+				       struct gdbarch *,
+				       struct bp_target_info *);
+
+/* The saved to_insert_hw_breakpoint and to_remove_hw_breakpoint
+   methods.  Called by ours, which make inserting an already inserted
+   hardware breakpoint a no-op.  */
+static int (*super_insert_hw_breakpoint) (struct target_ops *,
+					  struct gdbarch *,
+					  struct bp_target_info *);
+static int (*super_remove_hw_breakpoint) (struct target_ops *,
+					  struct gdbarch *,
+					  struct bp_target_info *);
+
 static unsigned int debug_linux_nat;
 static void
 show_debug_linux_nat (struct ui_file *file, int from_tty,
@@ -284,6 +309,8 @@ static int lwp_status_pending_p (struct lwp_info *lp);
 
 static int check_stopped_by_breakpoint (struct lwp_info *lp);
 static int sigtrap_is_event (int status);
+static void linux_proc_mem_file_close (int pid);
+static void forget_inserted_breakpoints (int pid);
 static int (*linux_nat_status_is_event) (int status) = sigtrap_is_event;
 
 
@@ -511,6 +538,10 @@ linux_child_follow_fork (struct target_ops *ops, int follow_child,
 	      ptrace (PTRACE_DETACH, child_pid, 0, signo);
 	    }
 
+	  /* Reading the child's memory to remove breakpoints may have
+	     opened its /proc/PID/mem.  */
+	  linux_proc_mem_file_close (ptid_get_pid (child_ptid));
+
 	  /* Resets value of inferior_ptid to parent ptid.  */
 	  do_cleanups (old_chain);
 	}
@@ -698,6 +729,29 @@ linux_child_set_syscall_catchpoint (struct target_ops *self,
 
 /* List of known LWPs.  */
 struct lwp_info *lwp_list;
+
+/* The LWPs of lwp_list, hashed by LWP id.  find_lwp_pid is called for
+   every event, and processes can have thousands of LWPs, so it must
+   not walk the list.  */
+static htab_t lwp_lwpid_htab;
+
+/* Wall time spent stopping and resuming all LWPs, and how often each
+   was done.  Reported with "set debug lin-lwp 1".  */
+
+struct lwp_phase_stats
+{
+  /* The name of the phase, for the debug output.  */
+  const char *name;
+
+  /* The number of times the phase ran.  */
+  unsigned long count;
+
+  /* The accumulated wall time of the phase.  */
+  struct timeval total;
+};
+
+static struct lwp_phase_stats stop_all_stats = { "stop" };
+static struct lwp_phase_stats resume_all_stats = { "resume" };
 
 
 /* Original signal mask.  */
@@ -774,14 +828,64 @@ lwp_free (struct lwp_info *lp)
   xfree (lp);
 }
 
+/* Hash and equality functions for lwp_lwpid_htab.  */
+
+static hashval_t
+lwp_info_hash (const void *ap)
+{
+  const struct lwp_info *lp = (const struct lwp_info *) ap;
+
+  return (hashval_t) ptid_get_lwp (lp->ptid);
+}
+
+static int
+lwp_lwpid_htab_eq (const void *a, const void *b)
+{
+  const struct lwp_info *entry = (const struct lwp_info *) a;
+  const struct lwp_info *element = (const struct lwp_info *) b;
+
+  return ptid_get_lwp (entry->ptid) == ptid_get_lwp (element->ptid);
+}
+
+/* Add LP to the front of the lwp list and to the LWP id table.  */
+
+static void
+lwp_list_add (struct lwp_info *lp)
+{
+  void **slot;
+
+  lp->prev = NULL;
+  lp->next = lwp_list;
+  if (lwp_list != NULL)
+    lwp_list->prev = lp;
+  lwp_list = lp;
+
+  slot = htab_find_slot (lwp_lwpid_htab, lp, INSERT);
+  gdb_assert (*slot == NULL);
+  *slot = lp;
+}
+
+/* Remove LP from the lwp list and from the LWP id table.  */
+
+static void
+lwp_list_remove (struct lwp_info *lp)
+{
+  htab_remove_elt (lwp_lwpid_htab, lp);
+
+  if (lp->prev != NULL)
+    lp->prev->next = lp->next;
+  else
+    lwp_list = lp->next;
+  if (lp->next != NULL)
+    lp->next->prev = lp->prev;
+}
+
 /* Remove all LWPs belong to PID from the lwp list.  */
 
 static void
 purge_lwp_list (int pid)
 {
-  struct lwp_info *lp, *lpprev, *lpnext;
-
-  lpprev = NULL;
+  struct lwp_info *lp, *lpnext;
 
   for (lp = lwp_list; lp; lp = lpnext)
     {
@@ -789,15 +893,9 @@ purge_lwp_list (int pid)
 
       if (ptid_get_pid (lp->ptid) == pid)
 	{
-	  if (lp == lwp_list)
-	    lwp_list = lp->next;
-	  else
-	    lpprev->next = lp->next;
-
+	  lwp_list_remove (lp);
 	  lwp_free (lp);
 	}
-      else
-	lpprev = lp;
     }
 }
 
@@ -832,8 +930,7 @@ add_initial_lwp (ptid_t ptid)
   lp->ptid = ptid;
   lp->core = -1;
 
-  lp->next = lwp_list;
-  lwp_list = lp;
+  lwp_list_add (lp);
 
   return lp;
 }
@@ -864,22 +961,16 @@ add_lwp (ptid_t ptid)
 static void
 delete_lwp (ptid_t ptid)
 {
-  struct lwp_info *lp, *lpprev;
-
-  lpprev = NULL;
-
-  for (lp = lwp_list; lp; lpprev = lp, lp = lp->next)
-    if (ptid_equal (lp->ptid, ptid))
-      break;
+  struct lwp_info *lp;
 
-  if (!lp)
+  if (!ptid_lwp_p (ptid))
     return;
 
-  if (lpprev)
-    lpprev->next = lp->next;
-  else
-    lwp_list = lp->next;
+  lp = find_lwp_pid (ptid);
+  if (lp == NULL || !ptid_equal (lp->ptid, ptid))
+    return;
 
+  lwp_list_remove (lp);
   lwp_free (lp);
 }
 
@@ -889,7 +980,7 @@ delete_lwp (ptid_t ptid)
 static struct lwp_info *
 find_lwp_pid (ptid_t ptid)
 {
-  struct lwp_info *lp;
+  struct lwp_info dummy;
   int lwp;
 
   if (ptid_lwp_p (ptid))
@@ -897,11 +988,31 @@ find_lwp_pid (ptid_t ptid)
   else
     lwp = ptid_get_pid (ptid);
 
-  for (lp = lwp_list; lp; lp = lp->next)
-    if (lwp == ptid_get_lwp (lp->ptid))
-      return lp;
+  dummy.ptid = ptid_build (0, lwp, 0);
+  return (struct lwp_info *) htab_find (lwp_lwpid_htab, &dummy);
+}
 
-  return NULL;
+/* Record that a phase which began at START has ended, in STATS.  */
+
+static void
+lwp_phase_done (struct lwp_phase_stats *stats, const struct timeval *start)
+{
+  struct timeval now, delta;
+
+  gettimeofday (&now, NULL);
+  timeval_sub (&delta, &now, start);
+  timeval_add (&stats->total, &stats->total, &delta);
+  stats->count++;
+
+  if (debug_linux_nat)
+    fprintf_unfiltered (gdb_stdlog,
+			"LNP: %s of all LWPs took %ld.%06ld s "
+			"(%lu times, %ld.%06ld s in total)\n",
+			stats->name,
+			(long) delta.tv_sec, (long) delta.tv_usec,
+			stats->count,
+			(long) stats->total.tv_sec,
+			(long) stats->total.tv_usec);
 }
 
 /* See nat/linux-nat.h.  */
@@ -1554,6 +1665,9 @@ linux_nat_detach (struct target_ops *ops, const char *args, int from_tty)
     linux_nat_prepare_to_resume (main_lwp);
   delete_lwp (main_lwp->ptid);
 
+  linux_proc_mem_file_close (pid);
+  forget_inserted_breakpoints (pid);
+
   if (forks_exist_p ())
     {
       /* Multi-fork case.  The current inferior_ptid is being detached
@@ -1823,7 +1937,13 @@ linux_nat_resume (struct target_ops *ops,
     }
 
   if (resume_many)
-    iterate_over_lwps (ptid, linux_nat_resume_callback, lp);
+    {
+      struct timeval start;
+
+      gettimeofday (&start, NULL);
+      iterate_over_lwps (ptid, linux_nat_resume_callback, lp);
+      lwp_phase_done (&resume_all_stats, &start);
+    }
 
   if (debug_linux_nat)
     fprintf_unfiltered (gdb_stdlog,
@@ -2151,6 +2271,10 @@ linux_handle_extended_wait (struct lwp_info *lp, int status)
       ourstatus->value.execd_pathname
 	= xstrdup (linux_child_pid_to_exec_file (NULL, pid));
 
+      /* The address space was replaced.  */
+      linux_proc_mem_file_close (ptid_get_pid (lp->ptid));
+      forget_inserted_breakpoints (ptid_get_pid (lp->ptid));
+
       /* The thread that execed must have been resumed, but, when a
 	 thread execs, it changes its tid to the tgid, and the old
 	 tgid thread might have not been resumed.  */
@@ -2396,12 +2520,18 @@ linux_stop_lwp (struct lwp_info *lwp)
 void
 linux_stop_and_wait_all_lwps (void)
 {
+  struct timeval start;
+
+  gettimeofday (&start, NULL);
+
   /* Stop all LWP's ...  */
   iterate_over_lwps (minus_one_ptid, stop_callback, NULL);
 
   /* ... and wait until all of them have reported back that
      they're no longer running.  */
   iterate_over_lwps (minus_one_ptid, stop_wait_callback, NULL);
+
+  lwp_phase_done (&stop_all_stats, &start);
 }
 
 /* See linux-nat.h  */
@@ -3057,6 +3187,622 @@ stop_and_resume_callback (struct lwp_info *lp, void *data)
   return 0;
 }
 
+/* Whether the native target claims support for target-side breakpoint
+   conditions.  Off by default; see "maint set
+   native-breakpoint-conditions".  When off, breakpoints are inserted
+   and removed without any bookkeeping.  */
+static int native_breakpoint_conditions = 0;
+
+/* The value "maint set native-breakpoint-conditions" sets, copied to
+   native_breakpoint_conditions by set_native_breakpoint_conditions.  */
+static int native_breakpoint_conditions_1 = 0;
+
+/* Implement "maint set native-breakpoint-conditions".  Breakpoints
+   inserted while the setting was off are not tracked, so it can't be
+   changed while they may be inserted.  */
+
+static void
+set_native_breakpoint_conditions (char *args, int from_tty,
+				  struct cmd_list_element *c)
+{
+  if (target_has_execution)
+    {
+      native_breakpoint_conditions_1 = native_breakpoint_conditions;
+      error (_("Cannot change this setting while the inferior is running."));
+    }
+
+  native_breakpoint_conditions = native_breakpoint_conditions_1;
+}
+
+/* Implement "maint show native-breakpoint-conditions".  */
+
+static void
+show_native_breakpoint_conditions (struct ui_file *file, int from_tty,
+				   struct cmd_list_element *c,
+				   const char *value)
+{
+  fprintf_filtered (file, _("Evaluation of breakpoint conditions by "
+			    "the native target is %s.\n"),
+		    value);
+}
+
+/* Breakpoints inserted through linux_nat_insert_breakpoint and
+   linux_nat_insert_hw_breakpoint while native_breakpoint_conditions
+   is on.  We keep track of the software
+   ones so that a hit can be matched with the target-side conditions
+   GDB attached to the breakpoint, and so that the breakpoint can be
+   stepped over without involving the core.  We keep track of all of
+   them so that inserting a breakpoint that is already inserted, as
+   GDB does when only its conditions changed, does nothing.
+
+   Entries are keyed on the process and the requested address, and
+   hold copies of everything they need.  The core does not keep a
+   location's bp_target_info at a fixed address: it moves it to a new
+   location when breakpoints are re-set, and it forgets about
+   breakpoints in unloaded shared libraries without removing them.  */
+
+struct inserted_breakpoint
+{
+  /* The process the breakpoint was inserted in.  */
+  int pid;
+
+  /* Non-zero if this is a hardware breakpoint.  */
+  int hw;
+
+  /* The architecture passed to the insert method.  */
+  struct gdbarch *gdbarch;
+
+  /* A copy of the target info of the breakpoint as it was inserted,
+     without its conditions and commands.  Used to lift the breakpoint
+     and to put it back when stepping over it.  */
+  struct bp_target_info bp_tgt;
+
+  /* Copies of the breakpoint's target-side conditions.  */
+  VEC (agent_expr_p) *conditions;
+};
+
+/* All inserted breakpoints, of all processes, keyed on the process,
+   the kind of breakpoint and the requested address.  */
+static htab_t inserted_breakpoints;
+
+/* Hash and equality functions for inserted_breakpoints.  */
+
+static hashval_t
+inserted_breakpoint_hash (const void *p)
+{
+  const struct inserted_breakpoint *ib
+    = (const struct inserted_breakpoint *) p;
+
+  return ((hashval_t) ib->bp_tgt.reqstd_address
+	  ^ (hashval_t) (ib->pid * 2 + ib->hw));
+}
+
+static int
+inserted_breakpoint_eq (const void *a, const void *b)
+{
+  const struct inserted_breakpoint *entry
+    = (const struct inserted_breakpoint *) a;
+  const struct inserted_breakpoint *element
+    = (const struct inserted_breakpoint *) b;
+
+  return (entry->pid == element->pid
+	  && entry->hw == element->hw
+	  && entry->bp_tgt.reqstd_address == element->bp_tgt.reqstd_address);
+}
+
+/* Return the slot of the inserted breakpoint of process PID requested
+   at ADDR, hardware if HW is non-zero, or NULL if there is none.  */
+
+static void **
+find_inserted_breakpoint_slot (int pid, int hw, CORE_ADDR addr)
+{
+  struct inserted_breakpoint key;
+
+  key.pid = pid;
+  key.hw = hw;
+  key.bp_tgt.reqstd_address = addr;
+  return htab_find_slot (inserted_breakpoints, &key, NO_INSERT);
+}
+
+/* Return the inserted breakpoint of process PID requested at ADDR,
+   hardware if HW is non-zero, or NULL if there is none.  */
+
+static struct inserted_breakpoint *
+find_inserted_breakpoint (int pid, int hw, CORE_ADDR addr)
+{
+  void **slot = find_inserted_breakpoint_slot (pid, hw, addr);
+
+  return slot != NULL ? (struct inserted_breakpoint *) *slot : NULL;
+}
+
+/* Data for find_inserted_breakpoint_at_callback.  */
+
+struct find_inserted_breakpoint_at_data
+{
+  int pid;
+  CORE_ADDR addr;
+  struct inserted_breakpoint *found;
+};
+
+/* htab_traverse callback for find_inserted_breakpoint_at.  */
+
+static int
+find_inserted_breakpoint_at_callback (void **slot, void *arg)
+{
+  struct inserted_breakpoint *ib = (struct inserted_breakpoint *) *slot;
+  struct find_inserted_breakpoint_at_data *data
+    = (struct find_inserted_breakpoint_at_data *) arg;
+
+  if (ib->pid == data->pid && !ib->hw
+      && ib->bp_tgt.placed_address == data->addr)
+    {
+      data->found = ib;
+      return 0;
+    }
+  return 1;
+}
+
+/* Return the inserted software breakpoint of process PID placed at
+   ADDR, or NULL if there is none.  The placed address is almost always
+   the requested one, so look that up first; only architectures that
+   adjust breakpoint addresses need the walk over the table.  */
+
+static struct inserted_breakpoint *
+find_inserted_breakpoint_at (int pid, CORE_ADDR addr)
+{
+  struct inserted_breakpoint *ib;
+  struct find_inserted_breakpoint_at_data data;
+
+  ib = find_inserted_breakpoint (pid, 0, addr);
+  if (ib != NULL && ib->bp_tgt.placed_address == addr)
+    return ib;
+
+  data.pid = pid;
+  data.addr = addr;
+  data.found = NULL;
+  htab_traverse_noresize (inserted_breakpoints,
+			  find_inserted_breakpoint_at_callback, &data);
+  return data.found;
+}
+
+/* Replace the conditions of IB with copies of CONDITIONS.  */
+
+static void
+inserted_breakpoint_set_conditions (struct inserted_breakpoint *ib,
+				    VEC (agent_expr_p) *conditions)
+{
+  struct agent_expr *aexpr;
+  int ix;
+
+  for (ix = 0; VEC_iterate (agent_expr_p, ib->conditions, ix, aexpr); ix++)
+    free_agent_expr (aexpr);
+  VEC_free (agent_expr_p, ib->conditions);
+
+  for (ix = 0; VEC_iterate (agent_expr_p, conditions, ix, aexpr); ix++)
+    {
+      struct agent_expr *copy = new_agent_expr (aexpr->gdbarch,
+						aexpr->scope);
+
+      xfree (copy->buf);
+      copy->buf = (unsigned char *) xmalloc (aexpr->len);
+      memcpy (copy->buf, aexpr->buf, aexpr->len);
+      copy->len = aexpr->len;
+      copy->size = aexpr->len;
+      VEC_safe_push (agent_expr_p, ib->conditions, copy);
+    }
+}
+
+/* Add a breakpoint of process PID to the table, hardware if HW is
+   non-zero, copying BP_TGT, which was just inserted.  */
+
+static void
+add_inserted_breakpoint (int pid, int hw, struct gdbarch *gdbarch,
+			 struct bp_target_info *bp_tgt)
+{
+  struct inserted_breakpoint *ib = XCNEW (struct inserted_breakpoint);
+  void **slot;
+
+  ib->pid = pid;
+  ib->hw = hw;
+  ib->gdbarch = gdbarch;
+  ib->bp_tgt = *bp_tgt;
+  ib->bp_tgt.conditions = NULL;
+  ib->bp_tgt.tcommands = NULL;
+  inserted_breakpoint_set_conditions (ib, bp_tgt->conditions);
+
+  slot = htab_find_slot (inserted_breakpoints, ib, INSERT);
+  gdb_assert (*slot == NULL);
+  *slot = ib;
+}
+
+/* Free IB, an entry of inserted_breakpoints.  This is the table's
+   delete function.  */
+
+static void
+free_inserted_breakpoint (void *p)
+{
+  struct inserted_breakpoint *ib = (struct inserted_breakpoint *) p;
+
+  inserted_breakpoint_set_conditions (ib, NULL);
+  xfree (ib);
+}
+
+/* Remove the breakpoint of process PID requested at ADDR, hardware if
+   HW is non-zero, from the table, if it is there.  */
+
+static void
+delete_inserted_breakpoint (int pid, int hw, CORE_ADDR addr)
+{
+  void **slot = find_inserted_breakpoint_slot (pid, hw, addr);
+
+  if (slot != NULL)
+    htab_clear_slot (inserted_breakpoints, slot);
+}
+
+/* htab_traverse callback for forget_inserted_breakpoints.  */
+
+static int
+forget_inserted_breakpoint_callback (void **slot, void *arg)
+{
+  struct inserted_breakpoint *ib = (struct inserted_breakpoint *) *slot;
+  int pid = *(int *) arg;
+
+  if (ib->pid == pid)
+    htab_clear_slot (inserted_breakpoints, slot);
+  return 1;
+}
+
+/* Forget about all breakpoints inserted in process PID.  Called when
+   the process is gone, detached from, or its address space is
+   replaced by an exec.  */
+
+static void
+forget_inserted_breakpoints (int pid)
+{
+  htab_traverse_noresize (inserted_breakpoints,
+			  forget_inserted_breakpoint_callback, &pid);
+}
+
+/* Return non-zero if the software breakpoint IB is still present in
+   the inferior's memory.  It is not if the core forgot about it
+   without removing it, e.g., because the shared library it was in
+   was unloaded.  */
+
+static int
+inserted_breakpoint_present_p (struct inserted_breakpoint *ib)
+{
+  CORE_ADDR addr = ib->bp_tgt.reqstd_address;
+  const gdb_byte *bp;
+  gdb_byte buf[BREAKPOINT_MAX];
+  int len;
+
+  bp = gdbarch_breakpoint_from_pc (ib->gdbarch, &addr, &len);
+  if (bp == NULL || len != ib->bp_tgt.placed_size
+      || addr != ib->bp_tgt.placed_address)
+    return 0;
+
+  return (target_read_raw_memory (addr, buf, len) == 0
+	  && memcmp (buf, bp, len) == 0);
+}
+
+/* The to_insert_breakpoint method of the GNU/Linux native target.  */
+
+static int
+linux_nat_insert_breakpoint (struct target_ops *ops,
+			     struct gdbarch *gdbarch,
+			     struct bp_target_info *bp_tgt)
+{
+  int pid = ptid_get_pid (inferior_ptid);
+  struct inserted_breakpoint *ib;
+  int ret;
+
+  if (!native_breakpoint_conditions)
+    return super_insert_breakpoint (ops, gdbarch, bp_tgt);
+
+  /* GDB re-inserts an already inserted location when only its
+     target-side conditions changed, and a location may take over the
+     inserted breakpoint of another one at the same address.  Don't
+     write the breakpoint instruction again, as that would clobber the
+     shadow contents; just refresh the conditions, and hand back the
+     shadow we saved.  */
+  ib = find_inserted_breakpoint (pid, 0, bp_tgt->reqstd_address);
+  if (ib != NULL)
+    {
+      if (inserted_breakpoint_present_p (ib))
+	{
+	  inserted_breakpoint_set_conditions (ib, bp_tgt->conditions);
+	  bp_tgt->placed_address = ib->bp_tgt.placed_address;
+	  bp_tgt->placed_size = ib->bp_tgt.placed_size;
+	  bp_tgt->shadow_len = ib->bp_tgt.shadow_len;
+	  memcpy (bp_tgt->shadow_contents, ib->bp_tgt.shadow_contents,
+		  ib->bp_tgt.shadow_len);
+	  return 0;
+	}
+
+      /* Stale; the core forgot about it.  */
+      delete_inserted_breakpoint (pid, 0, bp_tgt->reqstd_address);
+    }
+
+  ret = super_insert_breakpoint (ops, gdbarch, bp_tgt);
+  if (ret == 0)
+    add_inserted_breakpoint (pid, 0, gdbarch, bp_tgt);
+
+  return ret;
+}
+
+/* The to_remove_breakpoint method of the GNU/Linux native target.  */
+
+static int
+linux_nat_remove_breakpoint (struct target_ops *ops,
+			     struct gdbarch *gdbarch,
+			     struct bp_target_info *bp_tgt)
+{
+  if (native_breakpoint_conditions)
+    delete_inserted_breakpoint (ptid_get_pid (inferior_ptid), 0,
+				bp_tgt->reqstd_address);
+
+  return super_remove_breakpoint (ops, gdbarch, bp_tgt);
+}
+
+/* The to_insert_hw_breakpoint method of the GNU/Linux native target.
+   GDB inserts a single location per address, so while target-side
+   conditions are enabled, inserting a hardware breakpoint that is
+   already inserted means that GDB is only updating its conditions.
+   That must not take another reference on the debug register holding
+   it, or removing the breakpoint would leave the register armed.
+   Otherwise every insertion goes to the debug register code.  */
+
+static int
+linux_nat_insert_hw_breakpoint (struct target_ops *ops,
+				struct gdbarch *gdbarch,
+				struct bp_target_info *bp_tgt)
+{
+  int pid = ptid_get_pid (inferior_ptid);
+  int ret;
+
+  if (!native_breakpoint_conditions)
+    return super_insert_hw_breakpoint (ops, gdbarch, bp_tgt);
+
+  if (find_inserted_breakpoint (pid, 1, bp_tgt->reqstd_address) != NULL)
+    return 0;
+
+  ret = super_insert_hw_breakpoint (ops, gdbarch, bp_tgt);
+  if (ret == 0)
+    add_inserted_breakpoint (pid, 1, gdbarch, bp_tgt);
+
+  return ret;
+}
+
+/* The to_remove_hw_breakpoint method of the GNU/Linux native
+   target.  */
+
+static int
+linux_nat_remove_hw_breakpoint (struct target_ops *ops,
+				struct gdbarch *gdbarch,
+				struct bp_target_info *bp_tgt)
+{
+  if (native_breakpoint_conditions)
+    delete_inserted_breakpoint (ptid_get_pid (inferior_ptid), 1,
+				bp_tgt->reqstd_address);
+
+  return super_remove_hw_breakpoint (ops, gdbarch, bp_tgt);
+}
+
+/* The to_supports_evaluation_of_breakpoint_conditions method of the
+   GNU/Linux native target.  Stepping over a breakpoint whose
+   condition was false relies on hardware single-stepping.  */
+
+static int
+linux_nat_supports_evaluation_of_breakpoint_conditions
+  (struct target_ops *self)
+{
+  return (native_breakpoint_conditions
+	  && !gdbarch_software_single_step_p (target_gdbarch ()));
+}
+
+/* Return non-zero if LP, which is stopped at the inserted breakpoint
+   IB, should not be reported to the core, because the breakpoint has
+   target-side conditions and all of them evaluate to false.  If any
+   condition can't be evaluated, the hit is reported, and the core
+   evaluates the condition itself.  */
+
+static int
+inserted_breakpoint_conditions_false (struct inserted_breakpoint *ib,
+				      struct lwp_info *lp)
+{
+  struct cleanup *old_chain;
+  int all_false = 1;
+
+  if (VEC_empty (agent_expr_p, ib->conditions))
+    return 0;
+
+  /* Memory is read through INFERIOR_PTID.  */
+  old_chain = save_inferior_ptid ();
+  inferior_ptid = lp->ptid;
+
+  TRY
+    {
+      struct regcache *regcache = get_thread_regcache (lp->ptid);
+      struct agent_expr *aexpr;
+      int ix;
+
+      for (ix = 0;
+	   VEC_iterate (agent_expr_p, ib->conditions, ix, aexpr);
+	   ix++)
+	{
+	  ULONGEST value;
+
+	  if (ax_eval (aexpr, regcache, &value) != 0 || value != 0)
+	    {
+	      all_false = 0;
+	      break;
+	    }
+	}
+    }
+  CATCH (ex, RETURN_MASK_ERROR)
+    {
+      all_false = 0;
+    }
+  END_CATCH
+
+  do_cleanups (old_chain);
+  return all_false;
+}
+
+/* Callback for iterate_over_lwps.  Stop LP, unless it is the LWP
+   passed in DATA, or already stopped.  */
+
+static int
+stop_for_step_over_callback (struct lwp_info *lp, void *data)
+{
+  struct lwp_info *event_lp = (struct lwp_info *) data;
+
+  if (lp != event_lp && !lp->stopped)
+    stop_callback (lp, NULL);
+  return 0;
+}
+
+/* Callback for iterate_over_lwps.  Wait until LP, which
+   stop_for_step_over_callback asked to stop, stops.  If the core had
+   itself asked for LP to stop, the SIGSTOP we consume here is the
+   one it is waiting for, so leave it pending.  */
+
+static int
+stop_wait_for_step_over_callback (struct lwp_info *lp, void *data)
+{
+  struct lwp_info *event_lp = (struct lwp_info *) data;
+  ptid_t ptid = lp->ptid;
+
+  if (lp == event_lp || lp->stopped)
+    return 0;
+
+  stop_wait_callback (lp, NULL);
+
+  lp = find_lwp_pid (ptid);
+  if (lp != NULL
+      && lp->stopped
+      && lp->last_resume_kind == resume_stop
+      && !lwp_status_pending_p (lp))
+    lp->status = W_STOPCODE (SIGSTOP);
+
+  return 0;
+}
+
+/* Callback for iterate_over_lwps.  Return non-zero for any LWP.  */
+
+static int
+any_lwp_callback (struct lwp_info *lp, void *data)
+{
+  return 1;
+}
+
+/* LP just reported a software breakpoint hit.  If the breakpoint has
+   target-side conditions that are all false, step LP over the
+   breakpoint here and return non-zero, so that the event is
+   discarded instead of going all the way up to infrun, which would
+   evaluate the condition, find it false, and step over the
+   breakpoint itself, at a much higher cost.  Otherwise, return zero
+   and leave LP's event alone.
+
+   While the breakpoint is lifted, the other LWPs of the process are
+   kept stopped, so that they can't run past it.  They are resumed
+   along with every other stopped-but-resumed LWP by
+   linux_nat_wait_1.  */
+
+static int
+maybe_step_over_false_condition (struct lwp_info *lp)
+{
+  int pid = ptid_get_pid (lp->ptid);
+  ptid_t ptid = lp->ptid;
+  struct inserted_breakpoint *ib;
+  struct inferior *inf;
+  struct cleanup *old_chain;
+  int status;
+
+  if (!native_breakpoint_conditions
+      || lp->stop_reason != TARGET_STOPPED_BY_SW_BREAKPOINT
+      || lp->step
+      || lp->signalled
+      || !lp->resumed
+      || lp->last_resume_kind == resume_stop)
+    return 0;
+
+  /* Memory is shared with the other side of a vfork.  */
+  inf = find_inferior_pid (pid);
+  if (inf == NULL || inf->vfork_parent != NULL || inf->vfork_child != NULL)
+    return 0;
+
+  ib = find_inserted_breakpoint_at (pid, lp->stop_pc);
+  if (ib == NULL || !inserted_breakpoint_conditions_false (ib, lp))
+    return 0;
+
+  if (debug_linux_nat)
+    fprintf_unfiltered (gdb_stdlog,
+			"SOFC: condition false for %s at %s, stepping over\n",
+			target_pid_to_str (lp->ptid),
+			paddress (ib->gdbarch, lp->stop_pc));
+
+  iterate_over_lwps (pid_to_ptid (pid), stop_for_step_over_callback, lp);
+  iterate_over_lwps (pid_to_ptid (pid), stop_wait_for_step_over_callback, lp);
+
+  old_chain = save_inferior_ptid ();
+  inferior_ptid = ptid;
+
+  if (super_remove_breakpoint (linux_ops, ib->gdbarch, &ib->bp_tgt) != 0)
+    {
+      /* Let the core deal with it.  */
+      do_cleanups (old_chain);
+      return 0;
+    }
+
+  lp->status = 0;
+  lp->stop_reason = TARGET_STOPPED_BY_NO_REASON;
+  linux_resume_one_lwp (lp, 1, GDB_SIGNAL_0);
+  status = wait_lwp (lp);
+
+  /* LP may be gone now.  Put the breakpoint back through any LWP of
+     the process that is still around.  */
+  lp = find_lwp_pid (ptid);
+  if (lp == NULL)
+    {
+      struct lwp_info *any = iterate_over_lwps (pid_to_ptid (pid),
+						any_lwp_callback, NULL);
+
+      if (any != NULL)
+	inferior_ptid = any->ptid;
+    }
+  if (find_lwp_pid (inferior_ptid) != NULL
+      && super_insert_breakpoint (linux_ops, ib->gdbarch, &ib->bp_tgt) != 0)
+    warning (_("Could not re-insert breakpoint at %s after stepping "
+	       "over it."),
+	     paddress (ib->gdbarch, ib->bp_tgt.placed_address));
+
+  do_cleanups (old_chain);
+
+  if (lp == NULL)
+    return 1;
+
+  if (status != 0)
+    {
+      /* The single-step normally finishes with a plain SIGTRAP, which
+	 we swallow, leaving LP stopped for linux_nat_wait_1 to resume.
+	 Anything else (a signal, a watchpoint triggering, another
+	 breakpoint) is left pending to be reported.  */
+      lp->status = status;
+      save_sigtrap (lp);
+      if (WIFSTOPPED (status) && WSTOPSIG (status) == SIGTRAP
+	  && (lp->stop_reason == TARGET_STOPPED_BY_NO_REASON
+	      || lp->stop_reason == TARGET_STOPPED_BY_SINGLE_STEP))
+	{
+	  lp->status = 0;
+	  lp->stop_reason = TARGET_STOPPED_BY_NO_REASON;
+	}
+    }
+
+  lp->step = 0;
+  return 1;
+}
+
 /* Check if we should go on and pass this event to common code.
    Return the affected lwp if we are, or NULL otherwise.  */
 
@@ -3350,6 +4096,11 @@ linux_nat_filter_event (int lwpid, int status)
   gdb_assert (lp);
   lp->status = status;
   save_sigtrap (lp);
+
+  /* Filter out hits of breakpoints whose condition is false.  */
+  if (maybe_step_over_false_condition (lp))
+    return NULL;
+
   return lp;
 }
 
@@ -3561,12 +4312,18 @@ linux_nat_wait_1 (struct target_ops *ops,
 
   if (!target_is_non_stop_p ())
     {
+      struct timeval start;
+
+      gettimeofday (&start, NULL);
+
       /* Now stop all other LWP's ...  */
       iterate_over_lwps (minus_one_ptid, stop_callback, NULL);
 
       /* ... and wait until all of them have reported back that
 	 they're no longer running.  */
       iterate_over_lwps (minus_one_ptid, stop_wait_callback, NULL);
+
+      lwp_phase_done (&stop_all_stats, &start);
     }
 
   /* If we're not waiting for a specific LWP, choose an event LWP from
@@ -4143,10 +4900,107 @@ linux_child_pid_to_exec_file (struct target_ops *self, int pid)
   return linux_proc_pid_to_exec_file (pid);
 }
 
-/* Implement the to_xfer_partial interface for memory reads using the /proc
-   filesystem.  Because we can use a single read() call for /proc, this
-   can be much more efficient than banging away at PTRACE_PEEKTEXT,
-   but it doesn't support writes.  */
+/* The /proc/PID/mem files we keep open, one per traced process.
+   Opening the file for every transfer costs more than the transfer
+   itself for small reads, so the descriptor is cached until the
+   process exits, execs or is detached from.  */
+
+struct linux_proc_mem_file
+{
+  struct linux_proc_mem_file *next;
+
+  /* The process this file belongs to.  */
+  int pid;
+
+  /* The open descriptor.  */
+  int fd;
+
+  /* Nonzero if FD was opened for writing.  */
+  int writable;
+};
+
+static struct linux_proc_mem_file *linux_proc_mem_files;
+
+/* Return a descriptor for /proc/PID/mem, opening it if necessary, or
+   -1 if it can't be opened.  Set *WRITABLE to whether it can be used
+   for writing.  */
+
+static int
+linux_proc_mem_file_fd (int pid, int *writable)
+{
+  struct linux_proc_mem_file *file;
+  char filename[64];
+  int fd;
+
+  for (file = linux_proc_mem_files; file != NULL; file = file->next)
+    if (file->pid == pid)
+      {
+	*writable = file->writable;
+	return file->fd;
+      }
+
+  xsnprintf (filename, sizeof filename, "/proc/%d/mem", pid);
+  *writable = 1;
+  fd = gdb_open_cloexec (filename, O_RDWR | O_LARGEFILE, 0);
+  if (fd == -1)
+    {
+      *writable = 0;
+      fd = gdb_open_cloexec (filename, O_RDONLY | O_LARGEFILE, 0);
+      if (fd == -1)
+	return -1;
+    }
+
+  file = XNEW (struct linux_proc_mem_file);
+  file->pid = pid;
+  file->fd = fd;
+  file->writable = *writable;
+  file->next = linux_proc_mem_files;
+  linux_proc_mem_files = file;
+  return fd;
+}
+
+/* Close the cached /proc/PID/mem file of process PID, if any.  This
+   must be done whenever PID stops being the process we opened it for,
+   or its address space is replaced.  */
+
+static void
+linux_proc_mem_file_close (int pid)
+{
+  struct linux_proc_mem_file **filep;
+
+  for (filep = &linux_proc_mem_files; *filep != NULL; )
+    {
+      struct linux_proc_mem_file *file = *filep;
+
+      if (file->pid == pid)
+	{
+	  *filep = file->next;
+	  close (file->fd);
+	  xfree (file);
+	}
+      else
+	filep = &file->next;
+    }
+}
+
+#ifdef HAVE_PROCESS_VM_READV
+/* Nonzero if the kernel does not implement process_vm_readv and
+   process_vm_writev.  */
+static int process_vm_unsupported;
+
+/* The maximum number of iovecs we pass to process_vm_readv.  */
+#ifdef IOV_MAX
+#define LINUX_NAT_MAX_IOV IOV_MAX
+#else
+#define LINUX_NAT_MAX_IOV 1024
+#endif
+#endif
+
+/* Implement the to_xfer_partial interface for memory using
+   process_vm_readv/process_vm_writev or the /proc filesystem.  A
+   single system call can transfer the whole block, which is much
+   more efficient than banging away at PTRACE_PEEKTEXT and
+   PTRACE_POKETEXT.  */
 
 static enum target_xfer_status
 linux_proc_xfer_partial (struct target_ops *ops, enum target_object object,
@@ -4155,40 +5009,67 @@ linux_proc_xfer_partial (struct target_ops *ops, enum target_object object,
 			 ULONGEST offset, LONGEST len, ULONGEST *xfered_len)
 {
   LONGEST ret;
-  int fd;
-  char filename[64];
+  int fd, writable;
+  int pid;
 
-  if (object != TARGET_OBJECT_MEMORY || !readbuf)
+  if (object != TARGET_OBJECT_MEMORY)
     return TARGET_XFER_EOF;
 
-  /* Don't bother for one word.  */
-  if (len < 3 * sizeof (long))
-    return TARGET_XFER_EOF;
+  pid = ptid_get_pid (inferior_ptid);
 
-  /* We could keep this file open and cache it - possibly one per
-     thread.  That requires some juggling, but is even faster.  */
-  xsnprintf (filename, sizeof filename, "/proc/%d/mem",
-	     ptid_get_pid (inferior_ptid));
-  fd = gdb_open_cloexec (filename, O_RDONLY | O_LARGEFILE, 0);
-  if (fd == -1)
+#ifdef HAVE_PROCESS_VM_READV
+  /* process_vm_readv does not need a file descriptor at all, but it
+     only works on memory the inferior itself could access; for
+     instance, it can't write breakpoints into read-only code.  Fall
+     back to /proc/PID/mem for anything it refuses.  */
+  if (!process_vm_unsupported && (uintptr_t) offset == offset)
+    {
+      struct iovec local, remote;
+
+      local.iov_base = readbuf != NULL ? readbuf : (gdb_byte *) writebuf;
+      local.iov_len = len;
+      remote.iov_base = (void *) (uintptr_t) offset;
+      remote.iov_len = len;
+
+      if (readbuf != NULL)
+	ret = process_vm_readv (pid, &local, 1, &remote, 1, 0);
+      else
+	ret = process_vm_writev (pid, &local, 1, &remote, 1, 0);
+
+      if (ret > 0)
+	{
+	  *xfered_len = ret;
+	  return TARGET_XFER_OK;
+	}
+      if (ret == -1 && errno == ENOSYS)
+	process_vm_unsupported = 1;
+    }
+#endif
+
+  fd = linux_proc_mem_file_fd (pid, &writable);
+  if (fd == -1 || (writebuf != NULL && !writable))
     return TARGET_XFER_EOF;
 
   /* If pread64 is available, use it.  It's faster if the kernel
      supports it (only one syscall), and it's 64-bit safe even on
      32-bit platforms (for instance, SPARC debugging a SPARC64
-     application).  */
+     application).  Older kernels refuse writes to /proc/PID/mem;
+     inf-ptrace takes care of those.  */
 #ifdef HAVE_PREAD64
-  if (pread64 (fd, readbuf, len, offset) != len)
+  if (readbuf != NULL)
+    ret = pread64 (fd, readbuf, len, offset);
+  else
+    ret = pwrite64 (fd, writebuf, len, offset);
 #else
-  if (lseek (fd, offset, SEEK_SET) == -1 || read (fd, readbuf, len) != len)
-#endif
-    ret = 0;
+  if (lseek (fd, offset, SEEK_SET) == -1)
+    ret = -1;
+  else if (readbuf != NULL)
+    ret = read (fd, readbuf, len);
   else
-    ret = len;
-
-  close (fd);
+    ret = write (fd, writebuf, len);
+#endif
 
-  if (ret == 0)
+  if (ret <= 0)
     return TARGET_XFER_EOF;
   else
     {
@@ -4197,6 +5078,80 @@ linux_proc_xfer_partial (struct target_ops *ops, enum target_object object,
     }
 }
 
+/* Implement the to_read_memory_batch target method.  Read as many of
+   the requested blocks as possible with one process_vm_readv call
+   per LINUX_NAT_MAX_IOV blocks.  A block the kernel can't read
+   stops the call; we skip it and go on with the ones after it, and
+   leave the unread blocks to the generic code.  */
+
+static void
+linux_nat_read_memory_batch (struct target_ops *ops,
+			     struct memory_read_request *requests, int count)
+{
+#ifdef HAVE_PROCESS_VM_READV
+  struct iovec local[LINUX_NAT_MAX_IOV], remote[LINUX_NAT_MAX_IOV];
+  int index[LINUX_NAT_MAX_IOV];
+  int pid = ptid_get_pid (inferior_ptid);
+  int addr_bit = gdbarch_addr_bit (target_gdbarch ());
+  int next = 0;
+
+  while (next < count && !process_vm_unsupported)
+    {
+      int n = 0, i;
+      ssize_t ret;
+
+      for (; next < count && n < LINUX_NAT_MAX_IOV; next++)
+	{
+	  struct memory_read_request *req = &requests[next];
+	  CORE_ADDR addr = req->addr;
+
+	  if (req->status == TARGET_XFER_OK)
+	    continue;
+	  if (req->len == 0)
+	    {
+	      req->status = TARGET_XFER_OK;
+	      continue;
+	    }
+
+	  if (addr_bit < (sizeof (ULONGEST) * HOST_CHAR_BIT))
+	    addr &= ((ULONGEST) 1 << addr_bit) - 1;
+	  if ((uintptr_t) addr != addr)
+	    continue;
+
+	  local[n].iov_base = req->buf;
+	  local[n].iov_len = req->len;
+	  remote[n].iov_base = (void *) (uintptr_t) addr;
+	  remote[n].iov_len = req->len;
+	  index[n] = next;
+	  n++;
+	}
+
+      if (n == 0)
+	break;
+
+      ret = process_vm_readv (pid, local, n, remote, n, 0);
+      if (ret == -1)
+	{
+	  if (errno == ENOSYS)
+	    process_vm_unsupported = 1;
+	  ret = 0;
+	}
+
+      /* Transfers stop at the first block that could not be read
+	 in full.  */
+      for (i = 0; i < n && (size_t) ret >= local[i].iov_len; i++)
+	{
+	  requests[index[i]].status = TARGET_XFER_OK;
+	  ret -= local[i].iov_len;
+	}
+
+      /* Restart after the failing block.  */
+      if (i < n)
+	next = index[i] + 1;
+    }
+#endif
+}
+
 
 /* Enumerate spufs IDs for process PID.  */
 static LONGEST
@@ -4542,6 +5497,7 @@ linux_target_install_ops (struct target_ops *t)
 
   super_xfer_partial = t->to_xfer_partial;
   t->to_xfer_partial = linux_xfer_partial;
+  t->to_read_memory_batch = linux_nat_read_memory_batch;
 
   t->to_static_tracepoint_markers_by_strid
     = linux_child_static_tracepoint_markers_by_strid;
@@ -5022,6 +5978,17 @@ linux_nat_add_target (struct target_ops *t)
   super_close = t->to_close;
   t->to_close = linux_nat_close;
 
+  super_insert_breakpoint = t->to_insert_breakpoint;
+  t->to_insert_breakpoint = linux_nat_insert_breakpoint;
+  super_remove_breakpoint = t->to_remove_breakpoint;
+  t->to_remove_breakpoint = linux_nat_remove_breakpoint;
+  super_insert_hw_breakpoint = t->to_insert_hw_breakpoint;
+  t->to_insert_hw_breakpoint = linux_nat_insert_hw_breakpoint;
+  super_remove_hw_breakpoint = t->to_remove_hw_breakpoint;
+  t->to_remove_hw_breakpoint = linux_nat_remove_hw_breakpoint;
+  t->to_supports_evaluation_of_breakpoint_conditions
+    = linux_nat_supports_evaluation_of_breakpoint_conditions;
+
   t->to_stop = linux_nat_stop;
   t->to_interrupt = linux_nat_interrupt;
 
@@ -5082,6 +6049,9 @@ linux_nat_set_forget_process (struct target_ops *t,
 void
 linux_nat_forget_process (pid_t pid)
 {
+  linux_proc_mem_file_close (pid);
+  forget_inserted_breakpoints (pid);
+
   if (linux_nat_forget_process_hook != NULL)
     linux_nat_forget_process_hook (pid);
 }
@@ -5163,6 +6133,26 @@ Enables printf debugging output."),
 			   NULL,
 			   &setdebuglist, &showdebuglist);
 
+  add_setshow_boolean_cmd ("native-breakpoint-conditions", class_maintenance,
+			   &native_breakpoint_conditions_1, _("\
+Set whether the native target evaluates breakpoint conditions."), _("\
+Show whether the native target evaluates breakpoint conditions."), _("\
+When on, and breakpoint condition evaluation is \"auto\" or \"target\",\n\
+the native target evaluates the conditions of software breakpoints\n\
+when they are hit, and steps over the breakpoints whose conditions\n\
+are false without reporting them.  This can't be changed while the\n\
+inferior is running."),
+			   set_native_breakpoint_conditions,
+			   show_native_breakpoint_conditions,
+			   &maintenance_set_cmdlist,
+			   &maintenance_show_cmdlist);
+
+  lwp_lwpid_htab = htab_create (100, lwp_info_hash, lwp_lwpid_htab_eq,
+				NULL);
+  inserted_breakpoints = htab_create (100, inserted_breakpoint_hash,
+				      inserted_breakpoint_eq,
+				      free_inserted_breakpoint);
+
   /* Save this mask as the default.  */
   sigprocmask (SIG_SETMASK, NULL, &normal_mask);
 
@@ -108,6 +108,9 @@ struct lwp_info
 
   /* Next LWP in list.  */
   struct lwp_info *next;
+
+  /* Previous LWP in list.  */
+  struct lwp_info *prev;
 };
 
 /* The global list of LWPs, for ALL_LWPS.  Unlike the threads list,
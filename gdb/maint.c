@@ -951,6 +951,69 @@ make_command_stats_cleanup (int msg_type)
   return make_cleanup_dtor (report_command_stats, new_stat, xfree);
 }
 
+/* The start of a step timed by make_time_report_cleanup.  */
+
+struct time_report
+{
+  /* What is being timed.  */
+  char *what;
+
+  long start_cpu_time;
+  struct timeval start_wall_time;
+};
+
+/* Report the time used since the start recorded in ARG, a struct
+   time_report.  This is called as a cleanup.  */
+
+static void
+report_time (void *arg)
+{
+  struct time_report *report = (struct time_report *) arg;
+  long cpu_time = get_run_time () - report->start_cpu_time;
+  struct timeval now_wall_time, delta_wall_time;
+
+  gettimeofday (&now_wall_time, NULL);
+  timeval_sub (&delta_wall_time, &now_wall_time, &report->start_wall_time);
+
+  printf_unfiltered (_("%s: %ld.%06ld (cpu), %ld.%06ld (wall)\n"),
+		     report->what,
+		     cpu_time / 1000000, cpu_time % 1000000,
+		     (long) delta_wall_time.tv_sec,
+		     (long) delta_wall_time.tv_usec);
+}
+
+/* Free ARG, a struct time_report.  */
+
+static void
+free_time_report (void *arg)
+{
+  struct time_report *report = (struct time_report *) arg;
+
+  xfree (report->what);
+  xfree (report);
+}
+
+/* See maint.h.  */
+
+struct cleanup *
+make_time_report_cleanup (const char *format, ...)
+{
+  struct time_report *report;
+  va_list args;
+
+  if (!per_command_time)
+    return make_cleanup (null_cleanup, 0);
+
+  report = XNEW (struct time_report);
+  va_start (args, format);
+  report->what = xstrvprintf (format, args);
+  va_end (args);
+  report->start_cpu_time = get_run_time ();
+  gettimeofday (&report->start_wall_time, NULL);
+
+  return make_cleanup_dtor (report_time, report, free_time_report);
+}
+
 /* Handle unknown "mt set per-command" arguments.
    In this case have "mt set per-command on|off" affect every setting.  */
 
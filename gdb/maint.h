@@ -28,4 +28,12 @@ extern void set_per_command_space (int);
 
 extern struct cleanup *make_command_stats_cleanup (int);
 
+/* If "maint time" is on, return a cleanup that prints the CPU and
+   wall time used until it is run, labelled with FORMAT and the
+   following arguments as for printf.  Otherwise return a null
+   cleanup.  Use this to time the parts of a command.  */
+
+extern struct cleanup *make_time_report_cleanup (const char *format, ...)
+  ATTRIBUTE_PRINTF (1, 2);
+
 #endif /* MAINT_H */
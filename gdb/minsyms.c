@@ -51,6 +51,8 @@
 #include "language.h"
 #include "cli/cli-utils.h"
 #include "symbol.h"
+#include "maint.h"
+#include "worker-threads.h"
 
 /* Accumulate the minimal symbols for each objfile in bunches of BUNCH_SIZE.
    At the end, copy them all into one newly allocated location on an objfile's
@@ -108,37 +110,6 @@ msymbol_hash (const char *string)
   return hash;
 }
 
-/* Add the minimal symbol SYM to an objfile's minsym hash table, TABLE.  */
-static void
-add_minsym_to_hash_table (struct minimal_symbol *sym,
-			  struct minimal_symbol **table)
-{
-  if (sym->hash_next == NULL)
-    {
-      unsigned int hash
-	= msymbol_hash (MSYMBOL_LINKAGE_NAME (sym)) % MINIMAL_SYMBOL_HASH_SIZE;
-
-      sym->hash_next = table[hash];
-      table[hash] = sym;
-    }
-}
-
-/* Add the minimal symbol SYM to an objfile's minsym demangled hash table,
-   TABLE.  */
-static void
-add_minsym_to_demangled_hash_table (struct minimal_symbol *sym,
-                                  struct minimal_symbol **table)
-{
-  if (sym->demangled_hash_next == NULL)
-    {
-      unsigned int hash = msymbol_hash_iw (MSYMBOL_SEARCH_NAME (sym))
-	% MINIMAL_SYMBOL_HASH_SIZE;
-
-      sym->demangled_hash_next = table[hash];
-      table[hash] = sym;
-    }
-}
-
 /* Look through all the current minimal symbol tables and find the
    first minimal symbol that matches NAME.  If OBJF is non-NULL, limit
    the search to that objfile.  If SFILE is non-NULL, the only file-scope
@@ -1009,7 +980,15 @@ prim_record_minimal_symbol_full (const char *name, int name_len, int copy_name,
   msymbol = &msym_bunch->contents[msym_bunch_index];
   MSYMBOL_SET_LANGUAGE (msymbol, language_auto,
 			&objfile->per_bfd->storage_obstack);
-  MSYMBOL_SET_NAMES (msymbol, name, name_len, copy_name, objfile);
+
+  /* Only record the linkage name for now; install_minimal_symbols
+     demangles all the new names at once.  */
+  if ((copy_name || name[name_len] != '\0')
+      && !objfile->per_bfd->minsyms_read)
+    name = (const char *) obstack_copy0 (&objfile->per_bfd->storage_obstack,
+					 name, name_len);
+  msymbol->mginfo.name = name;
+  msymbol->names_pending = 1;
 
   SET_MSYMBOL_VALUE_ADDRESS (msymbol, address);
   MSYMBOL_SECTION (msymbol) = section;
@@ -1021,8 +1000,7 @@ prim_record_minimal_symbol_full (const char *name, int name_len, int copy_name,
      as it would also set the has_size flag.  */
   msymbol->size = 0;
 
-  /* The hash pointers must be cleared! If they're not,
-     add_minsym_to_hash_table will NOT add this msymbol to the hash table.  */
+  /* The hash pointers are set by build_minimal_symbol_hash_tables.  */
   msymbol->hash_next = NULL;
   msymbol->demangled_hash_next = NULL;
 
@@ -1188,37 +1166,178 @@ compact_minimal_symbols (struct minimal_symbol *msymbol, int mcount,
   return (mcount);
 }
 
+/* The number of minimal symbols handled by one task of
+   parallel_for_each when demangling or hashing them.  */
+
+#define MINSYM_CHUNK_SIZE 1024
+
+/* The data shared by the tasks of demangle_minimal_symbols_chunk and
+   hash_minimal_symbols_chunk.  */
+
+struct minsym_chunk_data
+{
+  /* The minimal symbols, and their number.  */
+  struct minimal_symbol *msymbols;
+  int count;
+
+  /* For demangle_minimal_symbols_chunk, the C++ demangled names of
+     the symbols whose names are pending, or NULL.  */
+  char **demangled;
+
+  /* For hash_minimal_symbols_chunk, the hash of the linkage names and
+     of the search names of the symbols.  */
+  unsigned int *hash;
+  unsigned int *demangled_hash;
+};
+
+/* Return the range of symbols handled by task I of DATA in *BEGIN and
+   *END.  */
+
+static void
+minsym_chunk_range (const struct minsym_chunk_data *data, int i,
+		    int *begin, int *end)
+{
+  *begin = i * MINSYM_CHUNK_SIZE;
+  *end = *begin + MINSYM_CHUNK_SIZE;
+  if (*end > data->count)
+    *end = data->count;
+}
+
+/* A parallel_for_each task computing the C++ demangled names of chunk
+   I of the minimal symbols in DATA.  This runs on worker threads, so
+   it uses bfd_demangle, which is reentrant, rather than gdb_demangle,
+   whose protection against demangler crashes is not.  */
+
+static void
+demangle_minimal_symbols_chunk (int i, void *arg)
+{
+  struct minsym_chunk_data *data = (struct minsym_chunk_data *) arg;
+  int j, end;
+
+  for (minsym_chunk_range (data, i, &j, &end); j < end; j++)
+    {
+      const char *name = MSYMBOL_LINKAGE_NAME (&data->msymbols[j]);
+
+      /* Only C++ names are demangled here; symbol_set_names tries
+	 the other languages, on the main thread.  Objective-C names
+	 never start with "_Z", so trying C++ first does not change
+	 the result.  */
+      if (data->msymbols[j].names_pending
+	  && name[0] == '_' && name[1] == 'Z')
+	data->demangled[j] = bfd_demangle (NULL, name,
+					   DMGL_PARAMS | DMGL_ANSI);
+    }
+}
+
+/* Set up the names of the minimal symbols among the COUNT at MSYMBOLS
+   whose names are pending.  The C++ names, which make up most of the
+   demangling work, are demangled on the worker threads.  */
+
+static void
+set_pending_minimal_symbol_names (struct objfile *objfile,
+				  struct minimal_symbol *msymbols, int count)
+{
+  struct minsym_chunk_data data;
+  int i;
+
+  memset (&data, 0, sizeof (data));
+  data.msymbols = msymbols;
+  data.count = count;
+  data.demangled = XCNEWVEC (char *, count);
+
+  parallel_for_each ((count + MINSYM_CHUNK_SIZE - 1) / MINSYM_CHUNK_SIZE,
+		     demangle_minimal_symbols_chunk, &data);
+
+  for (i = 0; i < count; i++)
+    {
+      struct minimal_symbol *msym = &msymbols[i];
+
+      if (!msym->names_pending)
+	continue;
+
+      symbol_set_names_cplus (&msym->mginfo, msym->mginfo.name,
+			      strlen (msym->mginfo.name), 0, objfile,
+			      data.demangled[i]);
+      msym->names_pending = 0;
+    }
+
+  xfree (data.demangled);
+}
+
+/* A parallel_for_each task computing the hashes of chunk I of the
+   minimal symbols in DATA.  */
+
+static void
+hash_minimal_symbols_chunk (int i, void *arg)
+{
+  struct minsym_chunk_data *data = (struct minsym_chunk_data *) arg;
+  int j, end;
+
+  for (minsym_chunk_range (data, i, &j, &end); j < end; j++)
+    {
+      struct minimal_symbol *msym = &data->msymbols[j];
+
+      data->hash[j] = (msymbol_hash (MSYMBOL_LINKAGE_NAME (msym))
+		       % MINIMAL_SYMBOL_HASH_SIZE);
+      if (MSYMBOL_SEARCH_NAME (msym) != MSYMBOL_LINKAGE_NAME (msym))
+	data->demangled_hash[j] = (msymbol_hash_iw (MSYMBOL_SEARCH_NAME (msym))
+				   % MINIMAL_SYMBOL_HASH_SIZE);
+    }
+}
+
 /* Build (or rebuild) the minimal symbol hash tables.  This is necessary
    after compacting or sorting the table since the entries move around
-   thus causing the internal minimal_symbol pointers to become jumbled.  */
+   thus causing the internal minimal_symbol pointers to become jumbled.
+
+   The hashes are computed on the worker threads, then the symbols are
+   linked into the tables in order on the main thread.  */
   
 static void
 build_minimal_symbol_hash_tables (struct objfile *objfile)
 {
   int i;
   struct minimal_symbol *msym;
+  struct minsym_chunk_data data;
+  struct minimal_symbol **hash_table = objfile->per_bfd->msymbol_hash;
+  struct minimal_symbol **demangled_hash_table
+    = objfile->per_bfd->msymbol_demangled_hash;
 
   /* Clear the hash tables.  */
   for (i = 0; i < MINIMAL_SYMBOL_HASH_SIZE; i++)
     {
-      objfile->per_bfd->msymbol_hash[i] = 0;
-      objfile->per_bfd->msymbol_demangled_hash[i] = 0;
+      hash_table[i] = 0;
+      demangled_hash_table[i] = 0;
     }
 
+  memset (&data, 0, sizeof (data));
+  data.msymbols = objfile->per_bfd->msymbols;
+  data.count = objfile->per_bfd->minimal_symbol_count;
+  data.hash = XNEWVEC (unsigned int, data.count);
+  data.demangled_hash = XNEWVEC (unsigned int, data.count);
+
+  parallel_for_each ((data.count + MINSYM_CHUNK_SIZE - 1) / MINSYM_CHUNK_SIZE,
+		     hash_minimal_symbols_chunk, &data);
+
   /* Now, (re)insert the actual entries.  */
-  for ((i = objfile->per_bfd->minimal_symbol_count,
-	msym = objfile->per_bfd->msymbols);
-       i > 0;
-       i--, msym++)
+  for (i = 0; i < data.count; i++)
     {
-      msym->hash_next = 0;
-      add_minsym_to_hash_table (msym, objfile->per_bfd->msymbol_hash);
+      msym = &data.msymbols[i];
+
+      msym->hash_next = hash_table[data.hash[i]];
+      hash_table[data.hash[i]] = msym;
 
       msym->demangled_hash_next = 0;
       if (MSYMBOL_SEARCH_NAME (msym) != MSYMBOL_LINKAGE_NAME (msym))
-	add_minsym_to_demangled_hash_table (msym,
-                                            objfile->per_bfd->msymbol_demangled_hash);
+	{
+	  unsigned int hash = data.demangled_hash[i];
+
+	  msym->demangled_hash_next = demangled_hash_table[hash];
+	  demangled_hash_table[hash] = msym;
+	}
     }
+
+  xfree (data.hash);
+  xfree (data.demangled_hash);
 }
 
 /* Add the minimal symbols in the existing bunches to the objfile's official
@@ -1258,6 +1377,8 @@ install_minimal_symbols (struct objfile *objfile)
 
   if (msym_count > 0)
     {
+      struct cleanup *back_to;
+
       if (symtab_create_debug)
 	{
 	  fprintf_unfiltered (gdb_stdlog,
@@ -1265,6 +1386,11 @@ install_minimal_symbols (struct objfile *objfile)
 			      msym_count, objfile_name (objfile));
 	}
 
+      back_to = make_time_report_cleanup (_("Installing %d minimal symbols "
+					    "of %s (%d threads)"),
+					  msym_count, objfile_name (objfile),
+					  worker_threads_count ());
+
       /* Allocate enough space in the obstack, into which we will gather the
          bunches of new and existing minimal symbols, sort them, and then
          compact out the duplicate entries.  Once we have a final table,
@@ -1329,11 +1455,17 @@ install_minimal_symbols (struct objfile *objfile)
       objfile->per_bfd->minimal_symbol_count = mcount;
       objfile->per_bfd->msymbols = msymbols;
 
+      /* Demangle the new symbols; this allocates on the storage
+	 obstack, so it must wait until the table is finished.  */
+      set_pending_minimal_symbol_names (objfile, msymbols, mcount);
+
       /* Now build the hash tables; we can't do this incrementally
          at an earlier point since we weren't finished with the obstack
 	 yet.  (And if the msymbol obstack gets moved, all the internal
 	 pointers to other msymbols need to be adjusted.)  */
       build_minimal_symbol_hash_tables (objfile);
+
+      do_cleanups (back_to);
     }
 }
 
@@ -75,6 +75,10 @@ struct objfile_pspace_info
 
   /* Nonzero if section map updates should be inhibited if possible.  */
   int inhibit_updates;
+
+  /* Incremented whenever an objfile is added, removed or relocated.
+     See objfiles_generation.  */
+  unsigned long generation;
 };
 
 /* Per-program-space data key.  */
@@ -450,6 +454,7 @@ allocate_objfile (bfd *abfd, const char *name, int flags)
 
   /* Rebuild section map next time we need it.  */
   get_objfile_pspace_data (objfile->pspace)->new_objfiles_available = 1;
+  get_objfile_pspace_data (objfile->pspace)->generation++;
 
   return objfile;
 }
@@ -744,6 +749,7 @@ free_objfile (struct objfile *objfile)
 
   /* Rebuild section map next time we need it.  */
   get_objfile_pspace_data (objfile->pspace)->section_map_dirty = 1;
+  get_objfile_pspace_data (objfile->pspace)->generation++;
 
   /* Free the map for static links.  There's no need to free static link
      themselves since they were allocated on the objstack.  */
@@ -906,6 +912,7 @@ objfile_relocate1 (struct objfile *objfile,
 
   /* Rebuild section map next time we need it.  */
   get_objfile_pspace_data (objfile->pspace)->section_map_dirty = 1;
+  get_objfile_pspace_data (objfile->pspace)->generation++;
 
   /* Update the table in exec_ops, used to read memory.  */
   ALL_OBJFILE_OSECTIONS (objfile, s)
@@ -1501,6 +1508,15 @@ objfiles_changed (void)
 {
   /* Rebuild section map next time we need it.  */
   get_objfile_pspace_data (current_program_space)->section_map_dirty = 1;
+  get_objfile_pspace_data (current_program_space)->generation++;
+}
+
+/* See comments in objfiles.h.  */
+
+unsigned long
+objfiles_generation (struct program_space *pspace)
+{
+  return get_objfile_pspace_data (pspace)->generation;
 }
 
 /* See comments in objfiles.h.  */
@@ -538,6 +538,13 @@ extern void objfile_set_sym_fns (struct objfile *objfile,
 
 extern void objfiles_changed (void);
 
+/* Return a number that changes whenever an objfile of PSPACE is
+   added, removed or relocated.  Caches of information derived from
+   the objfiles of PSPACE can compare it against the value they were
+   built with to detect that they are stale.  */
+
+extern unsigned long objfiles_generation (struct program_space *pspace);
+
 extern int is_addr_in_objfile (CORE_ADDR addr, const struct objfile *objfile);
 
 /* Return true if ADDRESS maps into one of the sections of a
@@ -57,6 +57,8 @@ static struct partial_symbol *lookup_partial_symbol (struct objfile *,
 						     const char *, int,
 						     domain_enum);
 
+static char *psymtab_search_name (const char *name);
+
 static const char *psymtab_to_fullname (struct partial_symtab *ps);
 
 static struct partial_symbol *find_pc_sect_psymbol (struct objfile *,
@@ -124,6 +126,323 @@ require_partial_symbols (struct objfile *objfile, int verbose)
   ALL_OBJFILES (objfile)	 \
     ALL_OBJFILE_PSYMTABS_REQUIRED (objfile, p)
 
+/* An objfile-wide index of the partial symbols' names, mapping each
+   name to the psymtabs that define it.  This lets a name lookup visit
+   only the few psymtabs that can possibly contain the name, instead
+   of binary-searching every psymtab of the objfile, and lets a search
+   with a name predicate call the predicate once per distinct name
+   rather than once per partial symbol.
+
+   The index is built on first use, once the objfile's psymtabs are
+   all read, and is discarded whenever a psymtab is added to or
+   removed from the objfile.  */
+
+/* Bits of psymtab_name_use.flags.  */
+
+enum psymtab_name_flag
+  {
+    /* The name is in the psymtab's global or static list.  */
+    PSYMTAB_NAME_GLOBAL = 1 << 0,
+    PSYMTAB_NAME_STATIC = 1 << 1,
+
+    /* One of the psymbols is a function (LOC_BLOCK), a type
+       (LOC_TYPEDEF), or anything else (a variable).  */
+    PSYMTAB_NAME_FUNCTION = 1 << 2,
+    PSYMTAB_NAME_TYPE = 1 << 3,
+    PSYMTAB_NAME_VARIABLE = 1 << 4
+  };
+
+/* A psymtab that defines a given name.  */
+
+struct psymtab_name_use
+{
+  struct psymtab_name_use *next;
+  struct partial_symtab *pst;
+
+  /* The position of PST in the objfile's psymtab list.  */
+  int order;
+
+  /* A mask of psymtab_name_flag bits.  */
+  unsigned int flags;
+};
+
+typedef struct psymtab_name_use *psymtab_name_use_p;
+DEF_VEC_P (psymtab_name_use_p);
+
+typedef struct partial_symtab *partial_symtab_p;
+DEF_VEC_P (partial_symtab_p);
+
+/* A distinct partial symbol search name.  */
+
+struct psymtab_name
+{
+  struct psymtab_name *next;
+
+  /* The name, as returned by SYMBOL_SEARCH_NAME.  */
+  const char *name;
+
+  /* The psymtabs defining the name, in the order of the objfile's
+     psymtab list.  */
+  struct psymtab_name_use *uses;
+};
+
+/* An entry of the index hash table.  All the names with the same
+   msymbol_hash_iw value share one entry, which makes it possible to
+   find the names that match a lookup name according to strcmp_iw,
+   even if they differ from it in whitespace or parameters.  */
+
+struct psymtab_name_slot
+{
+  unsigned int hash;
+  struct psymtab_name *names;
+};
+
+struct psymtab_name_index
+{
+  /* Hash table of struct psymtab_name_slot.  */
+  htab_t slots;
+
+  /* Storage for the slots, names and uses.  */
+  struct obstack storage;
+
+  /* Statistics.  */
+  unsigned int n_names;
+  unsigned int n_uses;
+};
+
+static const struct objfile_data *psymtab_name_index_key;
+
+static hashval_t
+hash_psymtab_name_slot (const void *p)
+{
+  const struct psymtab_name_slot *slot
+    = (const struct psymtab_name_slot *) p;
+
+  return slot->hash;
+}
+
+static int
+eq_psymtab_name_slot (const void *a, const void *b)
+{
+  const struct psymtab_name_slot *slot_a
+    = (const struct psymtab_name_slot *) a;
+  const struct psymtab_name_slot *slot_b
+    = (const struct psymtab_name_slot *) b;
+
+  return slot_a->hash == slot_b->hash;
+}
+
+static void
+free_psymtab_name_index (struct psymtab_name_index *index)
+{
+  htab_delete (index->slots);
+  obstack_free (&index->storage, NULL);
+  xfree (index);
+}
+
+/* Discard OBJFILE's name index, if any.  */
+
+static void
+invalidate_psymtab_name_index (struct objfile *objfile)
+{
+  struct psymtab_name_index *index
+    = (struct psymtab_name_index *) objfile_data (objfile,
+						  psymtab_name_index_key);
+
+  if (index != NULL)
+    {
+      free_psymtab_name_index (index);
+      set_objfile_data (objfile, psymtab_name_index_key, NULL);
+    }
+}
+
+/* Objfile data cleanup function for psymtab_name_index_key.  */
+
+static void
+psymtab_name_index_cleanup (struct objfile *objfile, void *arg)
+{
+  if (arg != NULL)
+    free_psymtab_name_index ((struct psymtab_name_index *) arg);
+}
+
+/* Record in INDEX that the psymtab PST, at position ORDER in the
+   psymtab list, defines PSYM, which is in its global list if GLOBAL,
+   and in its static list otherwise.  */
+
+static void
+add_psymtab_name (struct psymtab_name_index *index,
+		  struct partial_symtab *pst, int order,
+		  struct partial_symbol *psym, int global)
+{
+  const char *name = SYMBOL_SEARCH_NAME (psym);
+  struct psymtab_name_slot key, *slot;
+  struct psymtab_name *entry;
+  struct psymtab_name_use *use;
+  unsigned int flags;
+  void **p;
+
+  key.hash = msymbol_hash_iw (name);
+  p = htab_find_slot_with_hash (index->slots, &key, key.hash, INSERT);
+  slot = (struct psymtab_name_slot *) *p;
+  if (slot == NULL)
+    {
+      slot = XOBNEW (&index->storage, struct psymtab_name_slot);
+      slot->hash = key.hash;
+      slot->names = NULL;
+      *p = slot;
+    }
+
+  for (entry = slot->names; entry != NULL; entry = entry->next)
+    if (strcmp (entry->name, name) == 0)
+      break;
+  if (entry == NULL)
+    {
+      entry = XOBNEW (&index->storage, struct psymtab_name);
+      entry->name = name;
+      entry->uses = NULL;
+      entry->next = slot->names;
+      slot->names = entry;
+      index->n_names++;
+    }
+
+  flags = global ? PSYMTAB_NAME_GLOBAL : PSYMTAB_NAME_STATIC;
+  if (PSYMBOL_CLASS (psym) == LOC_BLOCK)
+    flags |= PSYMTAB_NAME_FUNCTION;
+  else if (PSYMBOL_CLASS (psym) == LOC_TYPEDEF)
+    flags |= PSYMTAB_NAME_TYPE;
+  else
+    flags |= PSYMTAB_NAME_VARIABLE;
+
+  /* The psymbols of a psymtab are all added in a row, so if PST
+     already uses the name, it is the first use.  */
+  use = entry->uses;
+  if (use == NULL || use->pst != pst)
+    {
+      use = XOBNEW (&index->storage, struct psymtab_name_use);
+      use->pst = pst;
+      use->order = order;
+      use->flags = 0;
+      use->next = entry->uses;
+      entry->uses = use;
+      index->n_uses++;
+    }
+  use->flags |= flags;
+}
+
+/* Return the name index of OBJFILE, building it if necessary.  */
+
+static struct psymtab_name_index *
+psymtab_name_index (struct objfile *objfile)
+{
+  struct psymtab_name_index *index;
+  struct partial_symtab *ps;
+  VEC (partial_symtab_p) *psymtabs = NULL;
+  struct cleanup *cleanup;
+  int ix;
+
+  require_partial_symbols (objfile, 1);
+
+  index = (struct psymtab_name_index *) objfile_data (objfile,
+						       psymtab_name_index_key);
+  if (index != NULL)
+    return index;
+
+  index = XCNEW (struct psymtab_name_index);
+  index->slots = htab_create_alloc (1024, hash_psymtab_name_slot,
+				    eq_psymtab_name_slot, NULL,
+				    xcalloc, xfree);
+  obstack_init (&index->storage);
+
+  /* Add the psymtabs from the oldest to the newest, so that the
+     (prepended) uses of each name end up in the order of the psymtab
+     list, which is the order psymtabs are searched in.  IX is the
+     position of the psymtab in the list.  */
+  cleanup = make_cleanup (VEC_cleanup (partial_symtab_p), &psymtabs);
+  for (ps = objfile->psymtabs; ps != NULL; ps = ps->next)
+    VEC_safe_push (partial_symtab_p, psymtabs, ps);
+
+  for (ix = VEC_length (partial_symtab_p, psymtabs) - 1; ix >= 0; ix--)
+    {
+      struct partial_symbol **psym, **bound;
+
+      ps = VEC_index (partial_symtab_p, psymtabs, ix);
+
+      psym = objfile->global_psymbols.list + ps->globals_offset;
+      bound = psym + ps->n_global_syms;
+      for (; psym < bound; psym++)
+	add_psymtab_name (index, ps, ix, *psym, 1);
+
+      psym = objfile->static_psymbols.list + ps->statics_offset;
+      bound = psym + ps->n_static_syms;
+      for (; psym < bound; psym++)
+	add_psymtab_name (index, ps, ix, *psym, 0);
+    }
+  do_cleanups (cleanup);
+
+  set_objfile_data (objfile, psymtab_name_index_key, index);
+  return index;
+}
+
+/* qsort comparison function for psymtab_name_use pointers, ordering
+   them by psymtab list position.  */
+
+static int
+compare_psymtab_name_uses (const void *a, const void *b)
+{
+  const struct psymtab_name_use *use_a
+    = *(const struct psymtab_name_use * const *) a;
+  const struct psymtab_name_use *use_b
+    = *(const struct psymtab_name_use * const *) b;
+
+  return use_a->order - use_b->order;
+}
+
+/* Return the psymtabs of OBJFILE defining a name that matches
+   SEARCH_NAME according to strcmp_iw, with any of the
+   psymtab_name_flag bits in FLAGS.  Each psymtab is returned once,
+   and they are in the order of the objfile's psymtab list.  The
+   caller must free the result.  */
+
+static VEC (partial_symtab_p) *
+psymtab_name_candidates (struct objfile *objfile, const char *search_name,
+			 unsigned int flags)
+{
+  struct psymtab_name_index *index = psymtab_name_index (objfile);
+  VEC (partial_symtab_p) *result = NULL;
+  VEC (psymtab_name_use_p) *uses = NULL;
+  struct psymtab_name_slot key, *slot;
+  struct psymtab_name *entry;
+  struct psymtab_name_use *use;
+  int ix;
+
+  key.hash = msymbol_hash_iw (search_name);
+  slot = (struct psymtab_name_slot *) htab_find_with_hash (index->slots,
+							   &key, key.hash);
+  if (slot == NULL)
+    return NULL;
+
+  for (entry = slot->names; entry != NULL; entry = entry->next)
+    if (strcmp_iw (entry->name, search_name) == 0)
+      for (use = entry->uses; use != NULL; use = use->next)
+	if ((use->flags & flags) != 0)
+	  VEC_safe_push (psymtab_name_use_p, uses, use);
+
+  /* Different names matching SEARCH_NAME (e.g., overloads differing
+     in their parameters) each have their own list of uses.  */
+  if (VEC_length (psymtab_name_use_p, uses) > 1)
+    qsort (VEC_address (psymtab_name_use_p, uses),
+	   VEC_length (psymtab_name_use_p, uses),
+	   sizeof (psymtab_name_use_p), compare_psymtab_name_uses);
+
+  for (ix = 0; VEC_iterate (psymtab_name_use_p, uses, ix, use); ix++)
+    if (VEC_empty (partial_symtab_p, result)
+	|| VEC_last (partial_symtab_p, result) != use->pst)
+      VEC_safe_push (partial_symtab_p, result, use->pst);
+
+  VEC_free (psymtab_name_use_p, uses);
+  return result;
+}
+
 /* Helper function for psym_map_symtabs_matching_filename that
    expands the symtabs and calls the iterator.  */
 
@@ -310,6 +629,23 @@ find_pc_sect_psymtab (struct objfile *objfile, CORE_ADDR pc,
 {
   struct partial_symtab *pst;
 
+  /* Don't read the partial symbols of an objfile that has not been
+     read yet, see "set defer-symbol-reading", unless PC is within one
+     of its sections.  A backtrace then reads only the objfiles its
+     frames are in.  Once PC is known to be in OBJFILE, read them here,
+     so that the address map below is there to be searched.  */
+  if ((objfile->flags & OBJF_PSYMTABS_READ) == 0)
+    {
+      struct obj_section *osect = find_pc_section (pc);
+
+      if (osect == NULL
+	  || (osect->objfile != objfile
+	      && osect->objfile != objfile->separate_debug_objfile_backlink))
+	return NULL;
+
+      require_partial_symbols (objfile, 1);
+    }
+
   /* Try just the PSYMTABS_ADDRMAP mapping first as it has better granularity
      than the later used TEXTLOW/TEXTHIGH one.  */
 
@@ -512,8 +848,21 @@ psym_lookup_symbol (struct objfile *objfile,
   struct partial_symtab *ps;
   const int psymtab_index = (block_index == GLOBAL_BLOCK ? 1 : 0);
   struct compunit_symtab *stab_best = NULL;
+  VEC (partial_symtab_p) *candidates;
+  char *search_name;
+  struct cleanup *cleanup;
+  int ix;
 
-  ALL_OBJFILE_PSYMTABS_REQUIRED (objfile, ps)
+  /* Only look in the psymtabs the name index says may define NAME.  */
+  search_name = psymtab_search_name (name);
+  candidates = psymtab_name_candidates (objfile, search_name,
+					(psymtab_index
+					 ? PSYMTAB_NAME_GLOBAL
+					 : PSYMTAB_NAME_STATIC));
+  xfree (search_name);
+  cleanup = make_cleanup (VEC_cleanup (partial_symtab_p), &candidates);
+
+  for (ix = 0; VEC_iterate (partial_symtab_p, candidates, ix, ps); ix++)
   {
     if (!ps->readin && lookup_partial_symbol (objfile, ps, name,
 					      psymtab_index, domain))
@@ -536,7 +885,10 @@ psym_lookup_symbol (struct objfile *objfile,
 
 	if (sym != NULL
 	    && strcmp_iw (SYMBOL_SEARCH_NAME (sym), name) == 0)
-	  return stab;
+	  {
+	    do_cleanups (cleanup);
+	    return stab;
+	  }
 	if (with_opaque != NULL
 	    && strcmp_iw (SYMBOL_SEARCH_NAME (with_opaque), name) == 0)
 	  stab_best = stab;
@@ -545,6 +897,7 @@ psym_lookup_symbol (struct objfile *objfile,
       }
   }
 
+  do_cleanups (cleanup);
   return stab_best;
 }
 
@@ -1064,6 +1417,7 @@ psym_print_stats (struct objfile *objfile)
 {
   int i;
   struct partial_symtab *ps;
+  struct psymtab_name_index *index;
 
   i = 0;
   ALL_OBJFILE_PSYMTABS_REQUIRED (objfile, ps)
@@ -1072,6 +1426,15 @@ psym_print_stats (struct objfile *objfile)
 	i++;
     }
   printf_filtered (_("  Number of psym tables (not yet expanded): %d\n"), i);
+
+  index = psymtab_name_index (objfile);
+  printf_filtered (_("  Number of distinct psymbol names: %u\n"),
+		   index->n_names);
+  printf_filtered (_("  Number of psymbol name index entries: %u\n"),
+		   index->n_uses);
+  printf_filtered (_("  Total memory used for psymbol name index: %s\n"),
+		   pulongest (obstack_memory_used (&index->storage)
+			      + htab_size (index->slots) * sizeof (void *)));
 }
 
 /* Psymtab version of dump.  See its definition in
@@ -1107,8 +1470,19 @@ psym_expand_symtabs_for_function (struct objfile *objfile,
 				  const char *func_name)
 {
   struct partial_symtab *ps;
+  VEC (partial_symtab_p) *candidates;
+  char *search_name;
+  struct cleanup *cleanup;
+  int ix;
 
-  ALL_OBJFILE_PSYMTABS_REQUIRED (objfile, ps)
+  search_name = psymtab_search_name (func_name);
+  candidates = psymtab_name_candidates (objfile, search_name,
+					(PSYMTAB_NAME_GLOBAL
+					 | PSYMTAB_NAME_STATIC));
+  xfree (search_name);
+  cleanup = make_cleanup (VEC_cleanup (partial_symtab_p), &candidates);
+
+  for (ix = 0; VEC_iterate (partial_symtab_p, candidates, ix, ps); ix++)
   {
     if (ps->readin)
       continue;
@@ -1119,6 +1493,8 @@ psym_expand_symtabs_for_function (struct objfile *objfile,
 	    != NULL))
       psymtab_to_symtab (objfile, ps);
   }
+
+  do_cleanups (cleanup);
 }
 
 /* Psymtab version of expand_all_symtabs.  See its definition in
@@ -1306,92 +1682,86 @@ psym_map_matching_symbols (struct objfile *objfile,
     }
 }
 
+/* Data passed to search_psymtab_names through htab_traverse.  */
+
+struct search_psymtab_names_data
+{
+  /* The psymtab_name_flag bits matching the search domain.  */
+  unsigned int flags;
+
+  expand_symtabs_symbol_matcher_ftype *sym_matcher;
+  void *data;
+};
+
+/* A helper for psym_expand_symtabs_matching, called through
+   htab_traverse on the name index slots.  Call the symbol matcher on
+   the names of SLOTP that psymtabs define in the requested domain,
+   and mark the psymtabs defining a matching name as found.  */
+
+static int
+search_psymtab_names (void **slotp, void *arg)
+{
+  struct psymtab_name_slot *slot = (struct psymtab_name_slot *) *slotp;
+  struct search_psymtab_names_data *search
+    = (struct search_psymtab_names_data *) arg;
+  struct psymtab_name *entry;
+
+  for (entry = slot->names; entry != NULL; entry = entry->next)
+    {
+      struct psymtab_name_use *use;
+      int in_domain = 0;
+
+      for (use = entry->uses; use != NULL; use = use->next)
+	if ((use->flags & search->flags) != 0
+	    && use->pst->searched_flag != PST_SEARCHED_AND_FOUND)
+	  {
+	    in_domain = 1;
+	    break;
+	  }
+      if (!in_domain)
+	continue;
+
+      QUIT;
+
+      if ((*search->sym_matcher) (entry->name, search->data))
+	for (use = entry->uses; use != NULL; use = use->next)
+	  if ((use->flags & search->flags) != 0)
+	    use->pst->searched_flag = PST_SEARCHED_AND_FOUND;
+    }
+
+  return 1;
+}
+
 /* A helper for psym_expand_symtabs_matching that handles
    searching included psymtabs.  This returns 1 if a symbol is found,
    and zero otherwise.  It also updates the 'searched_flag' on the
-   various psymtabs that it searches.  */
+   various psymtabs that it searches.  The psymtabs whose own symbols
+   match have already been marked found by search_psymtab_names.  */
 
 static int
-recursively_search_psymtabs (struct partial_symtab *ps,
-			     struct objfile *objfile,
-			     enum search_domain kind,
-			     expand_symtabs_symbol_matcher_ftype *sym_matcher,
-			     void *data)
+recursively_search_psymtabs (struct partial_symtab *ps)
 {
-  struct partial_symbol **psym;
-  struct partial_symbol **bound, **gbound, **sbound;
-  int keep_going = 1;
-  enum psymtab_search_status result = PST_SEARCHED_AND_NOT_FOUND;
   int i;
 
   if (ps->searched_flag != PST_NOT_SEARCHED)
     return ps->searched_flag == PST_SEARCHED_AND_FOUND;
 
-  /* Recurse into shared psymtabs first, because they may have already
-     been searched, and this could save some time.  */
+  /* Recurse into shared psymtabs.  */
   for (i = 0; i < ps->number_of_dependencies; ++i)
     {
-      int r;
-
       /* Skip non-shared dependencies, these are handled elsewhere.  */
       if (ps->dependencies[i]->user == NULL)
 	continue;
 
-      r = recursively_search_psymtabs (ps->dependencies[i],
-				       objfile, kind, sym_matcher, data);
-      if (r != 0)
+      if (recursively_search_psymtabs (ps->dependencies[i]))
 	{
 	  ps->searched_flag = PST_SEARCHED_AND_FOUND;
 	  return 1;
 	}
     }
 
-  gbound = (objfile->global_psymbols.list
-	    + ps->globals_offset + ps->n_global_syms);
-  sbound = (objfile->static_psymbols.list
-	    + ps->statics_offset + ps->n_static_syms);
-  bound = gbound;
-
-  /* Go through all of the symbols stored in a partial
-     symtab in one loop.  */
-  psym = objfile->global_psymbols.list + ps->globals_offset;
-  while (keep_going)
-    {
-      if (psym >= bound)
-	{
-	  if (bound == gbound && ps->n_static_syms != 0)
-	    {
-	      psym = objfile->static_psymbols.list + ps->statics_offset;
-	      bound = sbound;
-	    }
-	  else
-	    keep_going = 0;
-	  continue;
-	}
-      else
-	{
-	  QUIT;
-
-	  if ((kind == ALL_DOMAIN
-	       || (kind == VARIABLES_DOMAIN
-		   && PSYMBOL_CLASS (*psym) != LOC_TYPEDEF
-		   && PSYMBOL_CLASS (*psym) != LOC_BLOCK)
-	       || (kind == FUNCTIONS_DOMAIN
-		   && PSYMBOL_CLASS (*psym) == LOC_BLOCK)
-	       || (kind == TYPES_DOMAIN
-		   && PSYMBOL_CLASS (*psym) == LOC_TYPEDEF))
-	      && (*sym_matcher) (SYMBOL_SEARCH_NAME (*psym), data))
-	    {
-	      /* Found a match, so notify our caller.  */
-	      result = PST_SEARCHED_AND_FOUND;
-	      keep_going = 0;
-	    }
-	}
-      psym++;
-    }
-
-  ps->searched_flag = result;
-  return result == PST_SEARCHED_AND_FOUND;
+  ps->searched_flag = PST_SEARCHED_AND_NOT_FOUND;
+  return 0;
 }
 
 /* Psymtab version of expand_symtabs_matching.  See its definition in
@@ -1407,6 +1777,7 @@ psym_expand_symtabs_matching
    void *data)
 {
   struct partial_symtab *ps;
+  struct search_psymtab_names_data search;
 
   /* Clear the search flags.  */
   ALL_OBJFILE_PSYMTABS_REQUIRED (objfile, ps)
@@ -1414,6 +1785,29 @@ psym_expand_symtabs_matching
       ps->searched_flag = PST_NOT_SEARCHED;
     }
 
+  /* Find the psymtabs with a matching symbol, calling SYMBOL_MATCHER
+     once per distinct name.  */
+  switch (kind)
+    {
+    case VARIABLES_DOMAIN:
+      search.flags = PSYMTAB_NAME_VARIABLE;
+      break;
+    case FUNCTIONS_DOMAIN:
+      search.flags = PSYMTAB_NAME_FUNCTION;
+      break;
+    case TYPES_DOMAIN:
+      search.flags = PSYMTAB_NAME_TYPE;
+      break;
+    default:
+      search.flags = (PSYMTAB_NAME_VARIABLE | PSYMTAB_NAME_FUNCTION
+		      | PSYMTAB_NAME_TYPE);
+      break;
+    }
+  search.sym_matcher = symbol_matcher;
+  search.data = data;
+  htab_traverse_noresize (psymtab_name_index (objfile)->slots,
+			  search_psymtab_names, &search);
+
   ALL_OBJFILE_PSYMTABS_REQUIRED (objfile, ps)
     {
       QUIT;
@@ -1446,7 +1840,7 @@ psym_expand_symtabs_matching
 	    continue;
 	}
 
-      if (recursively_search_psymtabs (ps, objfile, kind, symbol_matcher, data))
+      if (recursively_search_psymtabs (ps))
 	{
 	  struct compunit_symtab *symtab =
 	    psymtab_to_symtab (objfile, ps);
@@ -1798,6 +2192,7 @@ allocate_psymtab (const char *filename, struct objfile *objfile)
 
   psymtab->next = objfile->psymtabs;
   objfile->psymtabs = psymtab;
+  invalidate_psymtab_name_index (objfile);
 
   if (symtab_create_debug)
     {
@@ -1845,6 +2240,8 @@ discard_psymtab (struct objfile *objfile, struct partial_symtab *pst)
 
   pst->next = objfile->free_psymtabs;
   objfile->free_psymtabs = pst;
+
+  invalidate_psymtab_name_index (objfile);
 }
 
 /* An object of this type is passed to discard_psymtabs_upto.  */
@@ -2140,6 +2537,9 @@ extern initialize_file_ftype _initialize_psymtab;
 void
 _initialize_psymtab (void)
 {
+  psymtab_name_index_key
+    = register_objfile_data_with_cleanup (NULL, psymtab_name_index_cleanup);
+
   add_cmd ("psymbols", class_maintenance, maintenance_print_psymbols, _("\
 Print dump of current partial symbol definitions.\n\
 Entries in the partial symbol table are dumped to file OUTFILE.\n\
@@ -74,7 +74,8 @@
    instruction.
 
    Each struct record_full_entry is linked to "record_full_list" by "prev"
-   and "next" pointers.  */
+   and "next" pointers.  The value of a register or memory entry
+   immediately follows the entry itself, see record_full_get_loc.  */
 
 struct record_full_mem_entry
 {
@@ -83,22 +84,12 @@ struct record_full_mem_entry
   /* Set this flag if target memory for this entry
      can no longer be accessed.  */
   int mem_entry_not_accessible;
-  union
-  {
-    gdb_byte *ptr;
-    gdb_byte buf[sizeof (gdb_byte *)];
-  } u;
 };
 
 struct record_full_reg_entry
 {
   unsigned short num;
   unsigned short len;
-  union 
-  {
-    gdb_byte *ptr;
-    gdb_byte buf[2 * sizeof (gdb_byte *)];
-  } u;
 };
 
 struct record_full_end_entry
@@ -136,7 +127,10 @@ enum record_full_type
    executing the instruction (including the PC in every case).  It 
    will also have one "mem" entry for each memory change.  Finally,
    each instruction will have an "end" entry that separates it from
-   the changes associated with the next instruction.  */
+   the changes associated with the next instruction.
+
+   Entries are not allocated one by one with malloc, but from a queue
+   of large chunks; see record_full_chunk.  */
 
 struct record_full_entry
 {
@@ -193,6 +187,41 @@ static struct record_full_entry *record_full_list = &record_full_first;
 static struct record_full_entry *record_full_arch_list_head = NULL;
 static struct record_full_entry *record_full_arch_list_tail = NULL;
 
+/* The entries of the execution log, and the values they record, are
+   carved out of large chunks of memory.  Entries are only ever added
+   at the end of the log, and removed either from its end (when the
+   log is truncated, or an instruction fails to be recorded) or from
+   its start (when the log is full).  So each chunk is filled in
+   order, and the chunks are kept in a queue; a chunk is freed once
+   all the entries it holds were released.  */
+
+#define RECORD_FULL_CHUNK_SIZE (64 * 1024)
+
+struct record_full_chunk
+{
+  struct record_full_chunk *prev;
+  struct record_full_chunk *next;
+
+  /* The entries.  */
+  gdb_byte *data;
+
+  /* The size of DATA.  */
+  size_t size;
+
+  /* The offsets in DATA of the oldest entry still in use, and of the
+     end of the newest one.  */
+  size_t begin;
+  size_t end;
+};
+
+/* The chunk holding the oldest entries, and the one holding the newest
+   entries.  */
+static struct record_full_chunk *record_full_chunk_head;
+static struct record_full_chunk *record_full_chunk_tail;
+
+/* The total size of the chunks.  */
+static ULONGEST record_full_chunk_bytes;
+
 /* 1 ask user. 0 auto delete the last struct record_full_entry.  */
 static int record_full_stop_at_limit = 1;
 /* Maximum allowed number of insns in execution log.  */
@@ -233,6 +262,124 @@ static void record_full_goto_insn (struct record_full_entry *entry,
 static void record_full_save (struct target_ops *self,
 			      const char *recfilename);
 
+/* Return the number of bytes taken by an entry recording a value of
+   LEN bytes, keeping the entry that follows it aligned.  */
+
+static inline size_t
+record_full_entry_size (int len)
+{
+  size_t align = sizeof (ULONGEST);
+
+  return (sizeof (struct record_full_entry) + len + align - 1) & ~(align - 1);
+}
+
+/* Return the number of bytes REC takes.  */
+
+static inline size_t
+record_full_entry_bytes (struct record_full_entry *rec)
+{
+  switch (rec->type)
+    {
+    case record_full_reg:
+      return record_full_entry_size (rec->u.reg.len);
+    case record_full_mem:
+      return record_full_entry_size (rec->u.mem.len);
+    default:
+      return record_full_entry_size (0);
+    }
+}
+
+/* Allocate a zeroed entry recording a value of LEN bytes, after all
+   the other entries.  */
+
+static struct record_full_entry *
+record_full_entry_alloc (enum record_full_type type, int len)
+{
+  size_t size = record_full_entry_size (len);
+  struct record_full_chunk *chunk = record_full_chunk_tail;
+  struct record_full_entry *rec;
+
+  if (chunk == NULL || chunk->size - chunk->end < size)
+    {
+      chunk = XCNEW (struct record_full_chunk);
+      chunk->size = max (size, RECORD_FULL_CHUNK_SIZE);
+      chunk->data = (gdb_byte *) xmalloc (chunk->size);
+      record_full_chunk_bytes += chunk->size;
+
+      chunk->prev = record_full_chunk_tail;
+      if (record_full_chunk_tail != NULL)
+	record_full_chunk_tail->next = chunk;
+      else
+	record_full_chunk_head = chunk;
+      record_full_chunk_tail = chunk;
+    }
+
+  rec = (struct record_full_entry *) (chunk->data + chunk->end);
+  memset (rec, 0, size);
+  rec->type = type;
+  chunk->end += size;
+
+  return rec;
+}
+
+/* Free CHUNK, which holds no entries anymore.  */
+
+static void
+record_full_chunk_free (struct record_full_chunk *chunk)
+{
+  if (chunk->prev != NULL)
+    chunk->prev->next = chunk->next;
+  else
+    record_full_chunk_head = chunk->next;
+  if (chunk->next != NULL)
+    chunk->next->prev = chunk->prev;
+  else
+    record_full_chunk_tail = chunk->prev;
+
+  record_full_chunk_bytes -= chunk->size;
+  xfree (chunk->data);
+  xfree (chunk);
+}
+
+/* Give back the memory of REC, which must be either the oldest or the
+   newest entry.  */
+
+static void
+record_full_entry_free (struct record_full_entry *rec)
+{
+  struct record_full_chunk *head = record_full_chunk_head;
+  struct record_full_chunk *tail = record_full_chunk_tail;
+  gdb_byte *p = (gdb_byte *) rec;
+  size_t size = record_full_entry_bytes (rec);
+
+  gdb_assert (head != NULL);
+
+  if (p == head->data + head->begin)
+    {
+      head->begin += size;
+      if (head->begin == head->end)
+	{
+	  if (head->next != NULL)
+	    record_full_chunk_free (head);
+	  else
+	    head->begin = head->end = 0;
+	}
+    }
+  else
+    {
+      gdb_assert (p + size == tail->data + tail->end);
+
+      tail->end -= size;
+      if (tail->begin == tail->end)
+	{
+	  if (tail->prev != NULL)
+	    record_full_chunk_free (tail);
+	  else
+	    tail->begin = tail->end = 0;
+	}
+    }
+}
+
 /* Alloc and free functions for record_full_reg, record_full_mem, and
    record_full_end entries.  */
 
@@ -243,13 +390,11 @@ record_full_reg_alloc (struct regcache *regcache, int regnum)
 {
   struct record_full_entry *rec;
   struct gdbarch *gdbarch = get_regcache_arch (regcache);
+  int len = register_size (gdbarch, regnum);
 
-  rec = XCNEW (struct record_full_entry);
-  rec->type = record_full_reg;
+  rec = record_full_entry_alloc (record_full_reg, len);
   rec->u.reg.num = regnum;
-  rec->u.reg.len = register_size (gdbarch, regnum);
-  if (rec->u.reg.len > sizeof (rec->u.reg.u.buf))
-    rec->u.reg.u.ptr = (gdb_byte *) xmalloc (rec->u.reg.len);
+  rec->u.reg.len = len;
 
   return rec;
 }
@@ -260,9 +405,7 @@ static inline void
 record_full_reg_release (struct record_full_entry *rec)
 {
   gdb_assert (rec->type == record_full_reg);
-  if (rec->u.reg.len > sizeof (rec->u.reg.u.buf))
-    xfree (rec->u.reg.u.ptr);
-  xfree (rec);
+  record_full_entry_free (rec);
 }
 
 /* Alloc a record_full_mem record entry.  */
@@ -272,12 +415,9 @@ record_full_mem_alloc (CORE_ADDR addr, int len)
 {
   struct record_full_entry *rec;
 
-  rec = XCNEW (struct record_full_entry);
-  rec->type = record_full_mem;
+  rec = record_full_entry_alloc (record_full_mem, len);
   rec->u.mem.addr = addr;
   rec->u.mem.len = len;
-  if (rec->u.mem.len > sizeof (rec->u.mem.u.buf))
-    rec->u.mem.u.ptr = (gdb_byte *) xmalloc (len);
 
   return rec;
 }
@@ -288,9 +428,7 @@ static inline void
 record_full_mem_release (struct record_full_entry *rec)
 {
   gdb_assert (rec->type == record_full_mem);
-  if (rec->u.mem.len > sizeof (rec->u.mem.u.buf))
-    xfree (rec->u.mem.u.ptr);
-  xfree (rec);
+  record_full_entry_free (rec);
 }
 
 /* Alloc a record_full_end record entry.  */
@@ -298,12 +436,7 @@ record_full_mem_release (struct record_full_entry *rec)
 static inline struct record_full_entry *
 record_full_end_alloc (void)
 {
-  struct record_full_entry *rec;
-
-  rec = XCNEW (struct record_full_entry);
-  rec->type = record_full_end;
-
-  return rec;
+  return record_full_entry_alloc (record_full_end, 0);
 }
 
 /* Free a record_full_end record entry.  */
@@ -311,7 +444,7 @@ record_full_end_alloc (void)
 static inline void
 record_full_end_release (struct record_full_entry *rec)
 {
-  xfree (rec);
+  record_full_entry_free (rec);
 }
 
 /* Free one record entry, any type.
@@ -357,6 +490,12 @@ record_full_list_release (struct record_full_entry *rec)
     {
       record_full_insn_num = 0;
       record_full_first.next = NULL;
+
+      /* Don't keep the last, now empty, chunk around.  */
+      if (record_full_chunk_head != NULL
+	  && record_full_chunk_head == record_full_chunk_tail
+	  && record_full_chunk_head->begin == record_full_chunk_head->end)
+	record_full_chunk_free (record_full_chunk_head);
     }
   else
     record_full_entry_release (rec);
@@ -369,16 +508,24 @@ record_full_list_release_following (struct record_full_entry *rec)
 {
   struct record_full_entry *tmp = rec->next;
 
+  if (tmp == NULL)
+    return;
+
+  /* Release the newest entry first, see record_full_entry_free.  */
+  while (tmp->next)
+    tmp = tmp->next;
+
   rec->next = NULL;
-  while (tmp)
+  while (tmp != rec)
     {
-      rec = tmp->next;
+      struct record_full_entry *prev = tmp->prev;
+
       if (record_full_entry_release (tmp) == record_full_end)
 	{
 	  record_full_insn_num--;
 	  record_full_insn_count--;
 	}
-      tmp = rec;
+      tmp = prev;
     }
 }
 
@@ -444,15 +591,8 @@ record_full_get_loc (struct record_full_entry *rec)
 {
   switch (rec->type) {
   case record_full_mem:
-    if (rec->u.mem.len > sizeof (rec->u.mem.u.buf))
-      return rec->u.mem.u.ptr;
-    else
-      return rec->u.mem.u.buf;
   case record_full_reg:
-    if (rec->u.reg.len > sizeof (rec->u.reg.u.buf))
-      return rec->u.reg.u.ptr;
-    else
-      return rec->u.reg.u.buf;
+    return (gdb_byte *) (rec + 1);
   case record_full_end:
   default:
     gdb_assert_not_reached ("unexpected record_full_entry type");
@@ -1828,6 +1968,10 @@ record_full_info (struct target_ops *self)
   /* Display max log size.  */
   printf_filtered (_("Max logged instructions is %u.\n"),
 		   record_full_insn_max_num);
+
+  /* Display the memory taken by the log.  */
+  printf_filtered (_("Log uses %s bytes of memory.\n"),
+		   pulongest (record_full_chunk_bytes));
 }
 
 /* The "to_record_delete" target method.  */
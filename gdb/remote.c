@@ -61,6 +61,7 @@
 #include "remote-fileio.h"
 #include "gdb/fileio.h"
 #include <sys/stat.h>
+#include <zlib.h>
 #include "xml-support.h"
 
 #include "memory-map.h"
@@ -304,6 +305,23 @@ struct readahead_cache
   ULONGEST miss_count;
 };
 
+/* Statistics about the packets sent and received in compressed
+   form.  */
+
+struct remote_compression_stats
+{
+  /* The number of packets sent compressed, and their total size
+     before and after compression.  */
+  ULONGEST packets_sent;
+  ULONGEST bytes_sent_raw;
+  ULONGEST bytes_sent;
+
+  /* Likewise for the packets received compressed.  */
+  ULONGEST packets_received;
+  ULONGEST bytes_received_raw;
+  ULONGEST bytes_received;
+};
+
 /* Description of the remote protocol state for the currently
    connected target.  This is per-target state, and independent of the
    selected architecture.  */
@@ -343,6 +361,13 @@ struct remote_state
      reliable.  */
   int noack_mode;
 
+  /* True if large packets may be sent and received compressed.  See
+     the QCompressPackets packet.  */
+  int compress_packets;
+
+  /* Statistics about packet compression.  */
+  struct remote_compression_stats compression_stats;
+
   /* True if we're connected in extended remote mode.  */
   int extended;
 
@@ -1478,6 +1503,12 @@ enum {
   /* Support for query supported vCont actions.  */
   PACKET_vContSupported,
 
+  /* Support for reading several memory ranges, in binary.  */
+  PACKET_vReadMem,
+
+  /* Support for compressing large packets.  */
+  PACKET_QCompressPackets,
+
   PACKET_MAX
 };
 
@@ -3756,6 +3787,7 @@ remote_start_remote (int from_tty, struct target_ops *target, int extended_p)
 {
   struct remote_state *rs = get_remote_state ();
   struct packet_config *noack_config;
+  struct packet_config *compress_config;
   char *wait_status = NULL;
 
   immediate_quit++;		/* Allow user to interrupt it.  */
@@ -3802,6 +3834,16 @@ remote_start_remote (int from_tty, struct target_ops *target, int extended_p)
 	rs->noack_mode = 1;
     }
 
+  /* Likewise, possibly enable the compression of large packets.  */
+  compress_config = &remote_protocol_packets[PACKET_QCompressPackets];
+  if (packet_config_support (compress_config) != PACKET_DISABLE)
+    {
+      putpkt ("QCompressPackets");
+      getpkt (&rs->buf, &rs->buf_size, 0);
+      if (packet_ok (rs->buf, compress_config) == PACKET_OK)
+	rs->compress_packets = 1;
+    }
+
   if (extended_p)
     {
       /* Tell the remote that we are using the extended protocol.  */
@@ -4392,7 +4434,10 @@ static const struct protocol_feature remote_protocol_features[] = {
     PACKET_exec_event_feature },
   { "Qbtrace-conf:pt:size", PACKET_DISABLE, remote_supported_packet,
     PACKET_Qbtrace_conf_pt_size },
-  { "vContSupported", PACKET_DISABLE, remote_supported_packet, PACKET_vContSupported }
+  { "vContSupported", PACKET_DISABLE, remote_supported_packet, PACKET_vContSupported },
+  { "vReadMem", PACKET_DISABLE, remote_supported_packet, PACKET_vReadMem },
+  { "QCompressPackets", PACKET_DISABLE, remote_supported_packet,
+    PACKET_QCompressPackets }
 };
 
 static char *remote_support_xml;
@@ -4696,6 +4741,8 @@ remote_open_1 (const char *name, int from_tty,
   rs->cached_wait_status = 0;
   rs->explicit_packet_size = 0;
   rs->noack_mode = 0;
+  rs->compress_packets = 0;
+  memset (&rs->compression_stats, 0, sizeof (rs->compression_stats));
   rs->extended = extended_p;
   rs->waiting_for_stop_reply = 0;
   rs->ctrlc_pending_p = 0;
@@ -7515,6 +7562,223 @@ remote_write_bytes (CORE_ADDR memaddr, const gdb_byte *myaddr, ULONGEST len,
 				 packet_format[0], 1);
 }
 
+/* The most vReadMem requests remote_read_bytes_binary keeps in flight
+   at once when the connection is in no-ack mode.  */
+
+#define REMOTE_READ_PIPELINE_DEPTH 8
+
+/* The room to leave in a vReadMem reply for the length prefix of a
+   range: a hex length and a colon.  */
+
+#define VREADMEM_RANGE_OVERHEAD (2 * sizeof (ULONGEST) + 1)
+
+/* Append the range ADDR,LEN to the vReadMem packet being built at P,
+   and return the new end of the packet.  FIRST is nonzero for the
+   first range of the packet.  */
+
+static char *
+remote_append_read_mem_range (char *p, CORE_ADDR addr, ULONGEST len,
+			      int first)
+{
+  *p++ = first ? ':' : ';';
+  p += hexnumstr (p, (ULONGEST) remote_address_masked (addr));
+  *p++ = ',';
+  p += hexnumstr (p, len);
+  *p = '\0';
+  return p;
+}
+
+/* Parse the part of a vReadMem reply at P, which ends at END, that
+   describes one range: its length in hex, a colon, and its contents
+   in escaped binary.  Store at most MAXLEN bytes of the contents into
+   BUF and their number into *XFERED.  Return a pointer past the
+   range, or NULL if the reply does not describe another range or is
+   malformed.  */
+
+static char *
+remote_parse_read_mem_range (char *p, char *end, gdb_byte *buf,
+			     ULONGEST maxlen, ULONGEST *xfered)
+{
+  ULONGEST len, i;
+
+  if (p >= end)
+    return NULL;
+
+  p = unpack_varlen_hex (p, &len);
+  if (p >= end || *p != ':' || len > maxlen)
+    return NULL;
+  p++;
+
+  for (i = 0; i < len; i++)
+    {
+      gdb_byte b;
+
+      if (p >= end)
+	return NULL;
+      b = *p++;
+      if (b == '}')
+	{
+	  if (p >= end)
+	    return NULL;
+	  b = *p++ ^ 0x20;
+	}
+      buf[i] = b;
+    }
+
+  *xfered = len;
+  return p;
+}
+
+/* Read LEN bytes at MEMADDR into MYADDR using vReadMem packets, whose
+   replies are binary rather than hex.  When the connection does not
+   use acknowledgments, several requests for consecutive parts of the
+   block are sent before waiting for the first reply, so that reading
+   a large block is bound by the bandwidth of the connection rather
+   than by its latency.  The return value and *XFERED_LEN are as for
+   remote_read_bytes_1.  */
+
+static enum target_xfer_status
+remote_read_bytes_binary (CORE_ADDR memaddr, gdb_byte *myaddr, ULONGEST len,
+			  ULONGEST *xfered_len)
+{
+  struct remote_state *rs = get_remote_state ();
+  long payload = get_memory_read_packet_size () - VREADMEM_RANGE_OVERHEAD;
+  ULONGEST chunk, done = 0;
+  int depth = 1, i, broken = 0;
+
+  /* One request may ask for as much as could fit unescaped; the stub
+     returns as much as fits in its reply.  Pipelined requests must
+     not come back short, or there would be holes in the data, so
+     they only ask for what fits even if every byte is escaped.  */
+  if (rs->noack_mode && len > payload)
+    {
+      chunk = payload / 2;
+      depth = min ((len + chunk - 1) / chunk, REMOTE_READ_PIPELINE_DEPTH);
+    }
+  else
+    chunk = min (len, payload);
+
+  for (i = 0; i < depth; i++)
+    {
+      ULONGEST offset = i * chunk;
+
+      strcpy (rs->buf, "vReadMem");
+      remote_append_read_mem_range (rs->buf + strlen (rs->buf),
+				    memaddr + offset,
+				    min (chunk, len - offset), 1);
+      putpkt (rs->buf);
+    }
+
+  /* Collect all the replies, even after a short one, so that none is
+     mistaken for the reply to a later request.  */
+  for (i = 0; i < depth; i++)
+    {
+      ULONGEST offset = i * chunk;
+      ULONGEST want = min (chunk, len - offset);
+      ULONGEST xfered = 0;
+      int reply_len;
+
+      reply_len = getpkt_sane (&rs->buf, &rs->buf_size, 0);
+      if (broken)
+	continue;
+
+      if (reply_len <= 0
+	  || (rs->buf[0] == 'E' && reply_len == 3
+	      && isxdigit (rs->buf[1]) && isxdigit (rs->buf[2]))
+	  || remote_parse_read_mem_range (rs->buf, rs->buf + reply_len,
+					  myaddr + offset, want,
+					  &xfered) == NULL)
+	xfered = 0;
+
+      done += xfered;
+      if (xfered < want)
+	broken = 1;
+    }
+
+  if (done == 0)
+    return TARGET_XFER_E_IO;
+
+  /* Return what we have.  Let higher layers handle partial reads.  */
+  *xfered_len = done;
+  return TARGET_XFER_OK;
+}
+
+/* Implement the to_read_memory_batch target method.  Pack as many of
+   the requested blocks as fit into each vReadMem packet.  */
+
+static void
+remote_read_memory_batch (struct target_ops *ops,
+			  struct memory_read_request *requests, int count)
+{
+  struct remote_state *rs = get_remote_state ();
+  long max_request = get_remote_packet_size () - 2 * VREADMEM_RANGE_OVERHEAD;
+  /* Ask for no more than fits in the reply even if every byte is
+     escaped, so that each block is read in full or not at all.  */
+  long max_reply = get_memory_read_packet_size () / 2;
+  int next = 0;
+
+  if (packet_support (PACKET_vReadMem) != PACKET_ENABLE
+      || gdbarch_addressable_memory_unit_size (target_gdbarch ()) != 1)
+    return;
+
+  while (next < count)
+    {
+      int index[64];
+      int n = 0, i, reply_len;
+      long reply_size = 0;
+      char *p, *reply, *end;
+
+      strcpy (rs->buf, "vReadMem");
+      p = rs->buf + strlen (rs->buf);
+
+      for (; next < count && n < ARRAY_SIZE (index); next++)
+	{
+	  struct memory_read_request *req = &requests[next];
+	  long size = VREADMEM_RANGE_OVERHEAD + req->len;
+
+	  if (req->status == TARGET_XFER_OK)
+	    continue;
+	  if (req->len == 0)
+	    {
+	      req->status = TARGET_XFER_OK;
+	      continue;
+	    }
+
+	  /* Leave blocks too big for any packet to the generic code.  */
+	  if (req->len > max_reply - VREADMEM_RANGE_OVERHEAD)
+	    continue;
+
+	  if (p - rs->buf >= max_request || reply_size + size > max_reply)
+	    break;
+
+	  p = remote_append_read_mem_range (p, req->addr, req->len, n == 0);
+	  reply_size += size;
+	  index[n++] = next;
+	}
+
+      if (n == 0)
+	break;
+
+      putpkt (rs->buf);
+      reply_len = getpkt_sane (&rs->buf, &rs->buf_size, 0);
+      if (reply_len <= 0 || (rs->buf[0] == 'E' && reply_len == 3))
+	continue;
+
+      reply = rs->buf;
+      end = rs->buf + reply_len;
+      for (i = 0; i < n && reply != NULL; i++)
+	{
+	  struct memory_read_request *req = &requests[index[i]];
+	  ULONGEST xfered;
+
+	  reply = remote_parse_read_mem_range (reply, end, req->buf,
+					       req->len, &xfered);
+	  if (reply != NULL && xfered == req->len)
+	    req->status = TARGET_XFER_OK;
+	}
+    }
+}
+
 /* Read memory data directly from the remote machine.
    This does not use the data cache; the data cache uses this.
    MEMADDR is the address in the remote memory space.
@@ -7539,6 +7803,10 @@ remote_read_bytes_1 (CORE_ADDR memaddr, gdb_byte *myaddr, ULONGEST len_units,
   int todo_units;
   int decoded_bytes;
 
+  if (unit_size == 1 && packet_support (PACKET_vReadMem) == PACKET_ENABLE)
+    return remote_read_bytes_binary (memaddr, myaddr, len_units,
+				     xfered_len_units);
+
   buf_size_bytes = get_memory_read_packet_size ();
   /* The packet buffer will be large enough for the payload;
      get_memory_packet_size ensures this.  */
@@ -7929,6 +8197,112 @@ putpkt (const char *buf)
   return putpkt_binary (buf, strlen (buf));
 }
 
+/* If packet compression is enabled and the CNT bytes of packet data
+   in BUF shrink when compressed, return a newly allocated buffer
+   holding the compressed packet data, and store its length in
+   *OUT_LEN.  Otherwise, return NULL.  */
+
+static char *
+remote_compress_packet (const char *buf, int cnt, int *out_len)
+{
+  struct remote_state *rs = get_remote_state ();
+  struct remote_compression_stats *stats = &rs->compression_stats;
+  gdb_byte *zbuf;
+  uLongf zlen;
+  char *out;
+  int header_len, len, units;
+
+  if (!rs->compress_packets || cnt < RSP_COMPRESS_THRESHOLD)
+    return NULL;
+
+  zlen = compressBound (cnt);
+  zbuf = (gdb_byte *) xmalloc (zlen);
+  if (compress2 (zbuf, &zlen, (const Bytef *) buf, cnt,
+		 Z_BEST_SPEED) != Z_OK)
+    {
+      xfree (zbuf);
+      return NULL;
+    }
+
+  /* Only keep the compressed form if it is smaller than the original
+     data, escapes included.  */
+  out = (char *) xmalloc (cnt);
+  header_len = xsnprintf (out, cnt, "%c%x:",
+			  RSP_COMPRESSED_PACKET_MARKER, cnt);
+  len = remote_escape_output (zbuf, zlen, 1, (gdb_byte *) out + header_len,
+			      &units, cnt - header_len - 1);
+  xfree (zbuf);
+  if (units < (int) zlen)
+    {
+      xfree (out);
+      return NULL;
+    }
+
+  stats->packets_sent++;
+  stats->bytes_sent_raw += cnt;
+  stats->bytes_sent += header_len + len;
+
+  *out_len = header_len + len;
+  return out;
+}
+
+/* If the LEN bytes of packet data just read into *BUF_P are a
+   compressed packet, replace them with the uncompressed data, growing
+   *BUF_P and *SIZEOF_BUF if necessary.  Return the length of the
+   resulting packet data, or -1 if it could not be decompressed.  */
+
+static long
+remote_decompress_packet (char **buf_p, long *sizeof_buf, long len)
+{
+  struct remote_state *rs = get_remote_state ();
+  struct remote_compression_stats *stats = &rs->compression_stats;
+  struct cleanup *old_chain;
+  ULONGEST raw_len;
+  uLongf out_len;
+  gdb_byte *zbuf;
+  char *p;
+  int zlen, status;
+
+  if (!rs->compress_packets || len == 0
+      || (*buf_p)[0] != RSP_COMPRESSED_PACKET_MARKER)
+    return len;
+
+  p = unpack_varlen_hex (*buf_p + 1, &raw_len);
+  if (*p != ':' || raw_len == 0 || raw_len > INT_MAX)
+    return -1;
+  p++;
+
+  zbuf = (gdb_byte *) xmalloc (len);
+  old_chain = make_cleanup (xfree, zbuf);
+  zlen = remote_unescape_input ((gdb_byte *) p, len - (p - *buf_p),
+				zbuf, len);
+
+  if (raw_len >= *sizeof_buf)
+    {
+      *sizeof_buf = raw_len + 1;
+      *buf_p = (char *) xrealloc (*buf_p, *sizeof_buf);
+    }
+
+  out_len = raw_len;
+  status = uncompress ((Bytef *) *buf_p, &out_len, zbuf, zlen);
+  do_cleanups (old_chain);
+  if (status != Z_OK || out_len != raw_len)
+    {
+      if (remote_debug)
+	fprintf_unfiltered (gdb_stdlog,
+			    "Could not decompress packet (status %d)\n",
+			    status);
+      return -1;
+    }
+  (*buf_p)[raw_len] = '\0';
+
+  stats->packets_received++;
+  stats->bytes_received_raw += raw_len;
+  stats->bytes_received += len;
+
+  return raw_len;
+}
+
 /* Send a packet to the remote machine, with error checking.  The data
    of the packet is in BUF.  The string in BUF can be at most
    get_remote_packet_size () - 5 to account for the $, # and checksum,
@@ -7948,6 +8322,8 @@ putpkt_binary (const char *buf, int cnt)
   int tcount = 0;
   char *p;
   char *message;
+  char *zbuf;
+  int zcnt;
 
   /* Catch cases like trying to read memory or listing threads while
      we're waiting for a stop reply.  The remote server wouldn't be
@@ -7967,6 +8343,16 @@ putpkt_binary (const char *buf, int cnt)
      stale cached response.  */
   rs->cached_wait_status = 0;
 
+  /* Send large packets compressed, if we can.  The compressed form is
+     always smaller, so it fits in BUF2.  */
+  zbuf = remote_compress_packet (buf, cnt, &zcnt);
+  if (zbuf != NULL)
+    {
+      make_cleanup (xfree, zbuf);
+      buf = zbuf;
+      cnt = zcnt;
+    }
+
   /* Copy the packet into buffer BUF2, encapsulating it
      and giving it a checksum.  */
 
@@ -8072,6 +8458,9 @@ putpkt_binary (const char *buf, int cnt)
 		/* We've found the start of a notification.  Now
 		   collect the data.  */
 		val = read_frame (&rs->buf, &rs->buf_size);
+		if (val >= 0)
+		  val = remote_decompress_packet (&rs->buf, &rs->buf_size,
+						  val);
 		if (val >= 0)
 		  {
 		    if (remote_debug)
@@ -8412,6 +8801,8 @@ getpkt_or_notif_sane_1 (char **buf, long *sizeof_buf, int forever,
 	      /* We've found the start of a packet or notification.
 		 Now collect the data.  */
 	      val = read_frame (buf, sizeof_buf);
+	      if (val >= 0)
+		val = remote_decompress_packet (buf, sizeof_buf, val);
 	      if (val >= 0)
 		break;
 	    }
@@ -10040,6 +10431,32 @@ packet_command (char *args, int from_tty)
   puts_filtered ("\n");
 }
 
+/* The "maintenance print remote-compression-stats" command.  */
+
+static void
+maintenance_print_remote_compression_stats (char *args, int from_tty)
+{
+  struct remote_state *rs = get_remote_state ();
+  struct remote_compression_stats *stats = &rs->compression_stats;
+
+  printf_filtered (_("Packet compression is %s.\n"),
+		   rs->compress_packets ? _("enabled") : _("disabled"));
+  printf_filtered (_("Packets sent compressed: %s "
+		     "(%s bytes compressed to %s bytes)\n"),
+		   pulongest (stats->packets_sent),
+		   pulongest (stats->bytes_sent_raw),
+		   pulongest (stats->bytes_sent));
+  printf_filtered (_("Packets received compressed: %s "
+		     "(%s bytes compressed to %s bytes)\n"),
+		   pulongest (stats->packets_received),
+		   pulongest (stats->bytes_received_raw),
+		   pulongest (stats->bytes_received));
+  printf_filtered (_("Bytes saved: %s\n"),
+		   pulongest (stats->bytes_sent_raw - stats->bytes_sent
+			      + stats->bytes_received_raw
+			      - stats->bytes_received));
+}
+
 #if 0
 /* --------- UNIT_TEST for THREAD oriented PACKETS ------------------- */
 
@@ -12758,6 +13175,7 @@ Specify the serial device it is connected to\n\
   remote_ops.to_can_execute_reverse = remote_can_execute_reverse;
   remote_ops.to_magic = OPS_MAGIC;
   remote_ops.to_memory_map = remote_memory_map;
+  remote_ops.to_read_memory_batch = remote_read_memory_batch;
   remote_ops.to_flash_erase = remote_flash_erase;
   remote_ops.to_flash_done = remote_flash_done;
   remote_ops.to_read_description = remote_read_description;
@@ -13152,6 +13570,13 @@ response packet.  GDB supplies the initial `$' character, and the\n\
 terminating `#' character and checksum."),
 	   &maintenancelist);
 
+  add_cmd ("remote-compression-stats", class_maintenance,
+	   maintenance_print_remote_compression_stats, _("\
+Print statistics about remote packet compression.\n\
+Shows how many packets were sent and received compressed, and how\n\
+many bytes compression saved, since GDB connected to the remote target."),
+	   &maintenanceprintlist);
+
   add_setshow_boolean_cmd ("remotebreak", no_class, &remote_break, _("\
 Set whether to send break if interrupted."), _("\
 Show whether to send break if interrupted."), _("\
@@ -13479,6 +13904,12 @@ Show the maximum size of the address (in bits) in a memory packet."), NULL,
   add_packet_config_cmd (&remote_protocol_packets[PACKET_exec_event_feature],
 			 "exec-event-feature", "exec-event-feature", 0);
 
+  add_packet_config_cmd (&remote_protocol_packets[PACKET_vReadMem],
+			 "vReadMem", "read-memory-ranges", 0);
+
+  add_packet_config_cmd (&remote_protocol_packets[PACKET_QCompressPackets],
+			 "QCompressPackets", "compress-packets", 0);
+
   /* Assert that we've registered "set remote foo-packet" commands
      for all packet configs.  */
   {
@@ -1342,13 +1342,40 @@ svr4_default_sos (void)
   return newobj;
 }
 
+/* The number of bytes of each shared object's name that
+   svr4_read_so_list fetches in its batched read.  Names which do not
+   fit are read again with target_read_string.  */
+
+#define SVR4_NAME_PREFETCH 128
+
+/* Free the shared objects left in the vector at P and the vector
+   itself (called via cleanup).  */
+
+static void
+svr4_free_so_vec (void *p)
+{
+  VEC (so_list_ptr) **vecp = (VEC (so_list_ptr) **) p;
+  struct so_list *so;
+  int ix;
+
+  for (ix = 0; VEC_iterate (so_list_ptr, *vecp, ix, so); ix++)
+    if (so != NULL)
+      free_so (so);
+
+  VEC_free (so_list_ptr, *vecp);
+}
+
 /* Read the whole inferior libraries chain starting at address LM.
    Expect the first entry in the chain's previous entry to be PREV_LM.
    Add the entries to the tail referenced by LINK_PTR_PTR.  Ignore the
    first entry if IGNORE_FIRST and set global MAIN_LM_ADDR according
    to it.  Returns nonzero upon success.  If zero is returned the
    entries stored to LINK_PTR_PTR are still valid although they may
-   represent only part of the inferior library list.  */
+   represent only part of the inferior library list.
+
+   The chain is walked first, and the names of all its entries are
+   then fetched with a single batched memory read, rather than with a
+   string read for each entry in turn.  */
 
 static int
 svr4_read_so_list (CORE_ADDR lm, CORE_ADDR prev_lm,
@@ -1356,33 +1383,37 @@ svr4_read_so_list (CORE_ADDR lm, CORE_ADDR prev_lm,
 {
   CORE_ADDR first_l_name = 0;
   CORE_ADDR next_lm;
+  VEC (so_list_ptr) *sos = NULL;
+  struct memory_read_request *requests;
+  gdb_byte *names;
+  struct cleanup *back_to;
+  struct so_list *newobj;
+  int ix, count;
+  int result = 1;
+
+  back_to = make_cleanup (svr4_free_so_vec, &sos);
 
   for (; lm != 0; prev_lm = lm, lm = next_lm)
     {
-      struct so_list *newobj;
-      struct cleanup *old_chain;
-      int errcode;
-      char *buffer;
-
-      newobj = XCNEW (struct so_list);
-      old_chain = make_cleanup_free_so (newobj);
+      struct lm_info *lm_info;
 
-      newobj->lm_info = lm_info_read (lm);
-      if (newobj->lm_info == NULL)
+      lm_info = lm_info_read (lm);
+      if (lm_info == NULL)
 	{
-	  do_cleanups (old_chain);
-	  return 0;
+	  result = 0;
+	  break;
 	}
 
-      next_lm = newobj->lm_info->l_next;
+      next_lm = lm_info->l_next;
 
-      if (newobj->lm_info->l_prev != prev_lm)
+      if (lm_info->l_prev != prev_lm)
 	{
 	  warning (_("Corrupted shared library list: %s != %s"),
 		   paddress (target_gdbarch (), prev_lm),
-		   paddress (target_gdbarch (), newobj->lm_info->l_prev));
-	  do_cleanups (old_chain);
-	  return 0;
+		   paddress (target_gdbarch (), lm_info->l_prev));
+	  xfree (lm_info);
+	  result = 0;
+	  break;
 	}
 
       /* For SVR4 versions, the first entry in the link map is for the
@@ -1390,52 +1421,91 @@ svr4_read_so_list (CORE_ADDR lm, CORE_ADDR prev_lm,
          SVR4, it has no name.  For others (Solaris 2.3 for example), it
          does have a name, so we can no longer use a missing name to
          decide when to ignore it.  */
-      if (ignore_first && newobj->lm_info->l_prev == 0)
+      if (ignore_first && lm_info->l_prev == 0)
 	{
 	  struct svr4_info *info = get_svr4_info ();
 
-	  first_l_name = newobj->lm_info->l_name;
-	  info->main_lm_addr = newobj->lm_info->lm_addr;
-	  do_cleanups (old_chain);
+	  first_l_name = lm_info->l_name;
+	  info->main_lm_addr = lm_info->lm_addr;
+	  xfree (lm_info);
 	  continue;
 	}
 
-      /* Extract this shared object's name.  */
-      target_read_string (newobj->lm_info->l_name, &buffer,
-			  SO_NAME_MAX_PATH_SIZE - 1, &errcode);
-      if (errcode != 0)
+      newobj = XCNEW (struct so_list);
+      newobj->lm_info = lm_info;
+      VEC_safe_push (so_list_ptr, sos, newobj);
+    }
+
+  /* Fetch the start of every entry's name at once.  */
+  count = VEC_length (so_list_ptr, sos);
+  requests = XCNEWVEC (struct memory_read_request, count);
+  make_cleanup (xfree, requests);
+  names = (gdb_byte *) xmalloc (count * SVR4_NAME_PREFETCH);
+  make_cleanup (xfree, names);
+
+  for (ix = 0; VEC_iterate (so_list_ptr, sos, ix, newobj); ix++)
+    {
+      requests[ix].addr = newobj->lm_info->l_name;
+      requests[ix].len = SVR4_NAME_PREFETCH;
+      requests[ix].buf = names + ix * SVR4_NAME_PREFETCH;
+    }
+
+  if (count > 0)
+    target_read_memory_batch (requests, count);
+
+  for (ix = 0; VEC_iterate (so_list_ptr, sos, ix, newobj); ix++)
+    {
+      const gdb_byte *name = requests[ix].buf;
+
+      /* The vector no longer owns the entry.  */
+      VEC_replace (so_list_ptr, sos, ix, NULL);
+
+      if (requests[ix].status == TARGET_XFER_OK
+	  && memchr (name, '\0', SVR4_NAME_PREFETCH) != NULL)
+	strcpy (newobj->so_name, (const char *) name);
+      else
 	{
-	  /* If this entry's l_name address matches that of the
-	     inferior executable, then this is not a normal shared
-	     object, but (most likely) a vDSO.  In this case, silently
-	     skip it; otherwise emit a warning. */
-	  if (first_l_name == 0 || newobj->lm_info->l_name != first_l_name)
-	    warning (_("Can't read pathname for load map: %s."),
-		     safe_strerror (errcode));
-	  do_cleanups (old_chain);
-	  continue;
-	}
+	  int errcode;
+	  char *buffer;
+
+	  /* The name is longer than what was fetched, or it ends near
+	     unreadable memory; read it the slow way.  */
+	  target_read_string (newobj->lm_info->l_name, &buffer,
+			      SO_NAME_MAX_PATH_SIZE - 1, &errcode);
+	  if (errcode != 0)
+	    {
+	      /* If this entry's l_name address matches that of the
+		 inferior executable, then this is not a normal shared
+		 object, but (most likely) a vDSO.  In this case, silently
+		 skip it; otherwise emit a warning. */
+	      if (first_l_name == 0 || newobj->lm_info->l_name != first_l_name)
+		warning (_("Can't read pathname for load map: %s."),
+			 safe_strerror (errcode));
+	      free_so (newobj);
+	      continue;
+	    }
 
-      strncpy (newobj->so_name, buffer, SO_NAME_MAX_PATH_SIZE - 1);
-      newobj->so_name[SO_NAME_MAX_PATH_SIZE - 1] = '\0';
+	  strncpy (newobj->so_name, buffer, SO_NAME_MAX_PATH_SIZE - 1);
+	  newobj->so_name[SO_NAME_MAX_PATH_SIZE - 1] = '\0';
+	  xfree (buffer);
+	}
       strcpy (newobj->so_original_name, newobj->so_name);
-      xfree (buffer);
 
       /* If this entry has no name, or its name matches the name
 	 for the main executable, don't include it in the list.  */
       if (! newobj->so_name[0] || match_main (newobj->so_name))
 	{
-	  do_cleanups (old_chain);
+	  free_so (newobj);
 	  continue;
 	}
 
-      discard_cleanups (old_chain);
       newobj->next = 0;
       **link_ptr_ptr = newobj;
       *link_ptr_ptr = &newobj->next;
     }
 
-  return 1;
+  do_cleanups (back_to);
+  return result;
 }
 
 /* Read the full list of currently loaded shared objects directly
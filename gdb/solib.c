@@ -36,6 +36,7 @@
 #include "gdbcmd.h"
 #include "completer.h"
 #include "filenames.h"		/* for DOSish file names */
+#include "hashtab.h"
 #include "exec.h"
 #include "solist.h"
 #include "observer.h"
@@ -737,6 +738,143 @@ solib_used (const struct so_list *const known)
   return 0;
 }
 
+/* An entry of the table update_solib_list builds to look up the
+   inferior's shared objects by name.  Shared objects with the same
+   name are chained in list order.  */
+
+struct solib_name_entry
+{
+  /* The name shared by the chained objects, and its hash.  */
+  const char *name;
+  hashval_t hash;
+
+  /* The shared object, or NULL once it has been matched.  */
+  struct so_list *so;
+
+  /* The next shared object with the same name.  */
+  struct solib_name_entry *next;
+};
+
+/* Hash and equality functions for a table of solib_name_entry.  */
+
+static hashval_t
+hash_solib_name_entry (const void *p)
+{
+  const struct solib_name_entry *entry
+    = (const struct solib_name_entry *) p;
+
+  return entry->hash;
+}
+
+static int
+eq_solib_name_entry (const void *a, const void *b)
+{
+  const struct solib_name_entry *entry
+    = (const struct solib_name_entry *) a;
+  const char *name = (const char *) b;
+
+  return filename_cmp (entry->name, name) == 0;
+}
+
+/* Return non-zero if GDB and INFERIOR describe the same shared
+   object, according to OPS.  */
+
+static int
+solib_same_p (const struct target_so_ops *ops,
+	      struct so_list *gdb, struct so_list *inferior)
+{
+  if (ops->same)
+    return ops->same (gdb, inferior);
+  return filename_cmp (gdb->so_original_name,
+		       inferior->so_original_name) == 0;
+}
+
+/* Match the shared objects on GDB's list that also appear, under the
+   same name, on the inferior's list INFERIOR.  Delete the matched
+   objects from *INFERIOR and add the matched GDB objects to MATCHED.
+   This takes time linear in the length of both lists.  */
+
+static void
+match_solibs_by_name (const struct target_so_ops *ops,
+		      struct so_list **inferior, htab_t matched)
+{
+  struct solib_name_entry *entries;
+  struct cleanup *back_to;
+  struct so_list *i, *gdb, **i_link;
+  htab_t names;
+  int count = 0;
+
+  for (i = *inferior; i != NULL; i = i->next)
+    count++;
+  if (count == 0)
+    return;
+
+  entries = XNEWVEC (struct solib_name_entry, count);
+  back_to = make_cleanup (xfree, entries);
+  names = htab_create_alloc (count * 2, hash_solib_name_entry,
+			     eq_solib_name_entry, NULL, xcalloc, xfree);
+  make_cleanup_htab_delete (names);
+
+  count = 0;
+  for (i = *inferior; i != NULL; i = i->next)
+    {
+      struct solib_name_entry *entry = &entries[count++];
+      void **slot;
+
+      entry->name = i->so_original_name;
+      entry->hash = filename_hash (entry->name);
+      entry->so = i;
+      entry->next = NULL;
+      slot = htab_find_slot_with_hash (names, entry->name, entry->hash,
+				       INSERT);
+      if (*slot == NULL)
+	*slot = entry;
+      else
+	{
+	  struct solib_name_entry *last = (struct solib_name_entry *) *slot;
+
+	  while (last->next != NULL)
+	    last = last->next;
+	  last->next = entry;
+	}
+    }
+
+  for (gdb = so_list_head; gdb != NULL; gdb = gdb->next)
+    {
+      struct solib_name_entry *entry;
+
+      entry = ((struct solib_name_entry *)
+	       htab_find_with_hash (names, gdb->so_original_name,
+				    filename_hash (gdb->so_original_name)));
+      for (; entry != NULL; entry = entry->next)
+	if (entry->so != NULL && solib_same_p (ops, gdb, entry->so))
+	  {
+	    *htab_find_slot (matched, entry->so, INSERT) = entry->so;
+	    *htab_find_slot (matched, gdb, INSERT) = gdb;
+	    entry->so = NULL;
+	    break;
+	  }
+    }
+
+  /* The inferior's objects are distinct from GDB's, so the table
+     tells which of them were matched.  */
+  i_link = inferior;
+  while (*i_link != NULL)
+    {
+      i = *i_link;
+      if (htab_find (matched, i) != NULL)
+	{
+	  htab_remove_elt (matched, i);
+	  *i_link = i->next;
+	  free_so (i);
+	}
+      else
+	i_link = &i->next;
+    }
+
+  do_cleanups (back_to);
+}
+
 /* Synchronize GDB's shared object list with inferior's.
 
    Extract the list of currently loaded shared objects from the
@@ -766,6 +904,8 @@ update_solib_list (int from_tty, struct target_ops *target)
   const struct target_so_ops *ops = solib_ops (target_gdbarch ());
   struct so_list *inferior = ops->current_sos();
   struct so_list *gdb, **gdb_link;
+  struct cleanup *back_to;
+  htab_t matched;
 
   /* We can reach here due to changing solib-search-path or the
      sysroot, before having any inferior.  */
@@ -804,7 +944,18 @@ update_solib_list (int from_tty, struct target_ops *target)
      we remove it from the inferior's list.  If it doesn't, the
      inferior has unloaded it, and we remove it from GDB's list.  By
      the time we're done walking GDB's list, the inferior's list
-     contains only the new shared objects, which we then add.  */
+     contains only the new shared objects, which we then add.
+
+     Processes can have thousands of shared objects, so first match
+     the objects with identical names using a hash table.  Only the
+     objects left over from that, which are normally just the ones
+     loaded or unloaded since the last update, are compared
+     pairwise.  */
+
+  matched = htab_create_alloc (16, htab_hash_pointer, htab_eq_pointer,
+			       NULL, xcalloc, xfree);
+  back_to = make_cleanup_htab_delete (matched);
+  match_solibs_by_name (ops, &inferior, matched);
 
   gdb = so_list_head;
   gdb_link = &so_list_head;
@@ -813,20 +964,19 @@ update_solib_list (int from_tty, struct target_ops *target)
       struct so_list *i = inferior;
       struct so_list **i_link = &inferior;
 
+      if (htab_find (matched, gdb) != NULL)
+	{
+	  gdb_link = &gdb->next;
+	  gdb = *gdb_link;
+	  continue;
+	}
+
       /* Check to see whether the shared object *gdb also appears in
 	 the inferior's current list.  */
       while (i)
 	{
-	  if (ops->same)
-	    {
-	      if (ops->same (gdb, i))
-		break;
-	    }
-	  else
-	    {
-	      if (! filename_cmp (gdb->so_original_name, i->so_original_name))
-		break;	      
-	    }
+	  if (solib_same_p (ops, gdb, i))
+	    break;
 
 	  i_link = &i->next;
 	  i = *i_link;
@@ -869,6 +1019,8 @@ update_solib_list (int from_tty, struct target_ops *target)
 	}
     }
 
+  do_cleanups (back_to);
+
   /* Now the inferior's list contains only shared objects that don't
      appear in GDB's list --- those that are newly loaded.  Add them
      to GDB's shared object list.  */
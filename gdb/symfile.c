@@ -81,6 +81,12 @@ static void clear_symtab_users_cleanup (void *ignore);
 /* Global variables owned by this file.  */
 int readnow_symbol_files;	/* Read full symbols immediately.  */
 
+/* If non-zero, the partial symbols of new symbol files are not read
+   when the files are loaded, but only when a command first needs
+   them.  */
+
+static int defer_symbol_reading = 0;
+
 /* Functions this file defines.  */
 
 static void load_command (char *, int);
@@ -895,7 +901,7 @@ read_symbols (struct objfile *objfile, int add_flags)
 
       do_cleanups (cleanup);
     }
-  if ((add_flags & SYMFILE_NO_READ) == 0)
+  if ((add_flags & SYMFILE_NO_READ) == 0 && !defer_symbol_reading)
     require_partial_symbols (objfile, 0);
 }
 
@@ -4055,4 +4061,18 @@ full  == print messages for the executable,\n\
 			NULL,
 			NULL,
 			&setprintlist, &showprintlist);
+
+  add_setshow_boolean_cmd ("defer-symbol-reading", class_files,
+			   &defer_symbol_reading, _("\
+Set whether reading the debug symbols of new symbol files is deferred."), _("\
+Show whether reading the debug symbols of new symbol files is deferred."), _("\
+When on, only the minimal symbols of a symbol file are read when it is\n\
+loaded, and its partial symbols are read by the first command that\n\
+needs them.  Looking up the code at an address only reads the file\n\
+containing the address, so attaching to a program with many shared\n\
+libraries and printing a backtrace is fast, but looking up a symbol\n\
+by name still reads all files."),
+			   NULL,
+			   NULL,
+			   &setlist, &showlist);
 }
@@ -641,6 +641,13 @@ extern void dwarf2_get_section_info (struct objfile *,
 
 extern int dwarf2_initialize_objfile (struct objfile *);
 extern void dwarf2_build_psymtabs (struct objfile *);
+
+/* Write the .gdb_index of OBJFILE, whose partial symbols have been
+   read, to FILENAME.  Return 1 if the file was written, or 0 if
+   OBJFILE cannot be indexed.  Throws an error if writing fails.  */
+
+extern int dwarf2_write_index (struct objfile *objfile,
+			       const char *filename);
 extern void dwarf2_build_frame_info (struct objfile *);
 
 void dwarf2_free_objfile (struct objfile *);
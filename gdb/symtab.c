@@ -851,6 +851,17 @@ void
 symbol_set_names (struct general_symbol_info *gsymbol,
 		  const char *linkage_name, int len, int copy_name,
 		  struct objfile *objfile)
+{
+  symbol_set_names_cplus (gsymbol, linkage_name, len, copy_name, objfile,
+			  NULL);
+}
+
+/* See symtab.h.  */
+
+void
+symbol_set_names_cplus (struct general_symbol_info *gsymbol,
+			const char *linkage_name, int len, int copy_name,
+			struct objfile *objfile, char *cplus_demangled)
 {
   struct demangled_name_entry **slot;
   /* A 0-terminated copy of the linkage name.  */
@@ -885,6 +896,7 @@ symbol_set_names (struct general_symbol_info *gsymbol,
 	  gsymbol->name = name;
 	}
       symbol_set_demangled_name (gsymbol, NULL, &per_bfd->storage_obstack);
+      xfree (cplus_demangled);
 
       return;
     }
@@ -939,9 +951,21 @@ symbol_set_names (struct general_symbol_info *gsymbol,
       || (gsymbol->language == language_go
 	  && (*slot)->demangled[0] == '\0'))
     {
-      char *demangled_name = symbol_find_demangled_name (gsymbol,
-							 linkage_name_copy);
-      int demangled_len = demangled_name ? strlen (demangled_name) : 0;
+      char *demangled_name;
+      int demangled_len;
+
+      if (cplus_demangled != NULL)
+	{
+	  if (gsymbol->language == language_unknown
+	      || gsymbol->language == language_auto)
+	    gsymbol->language = language_cplus;
+	  demangled_name = cplus_demangled;
+	  cplus_demangled = NULL;
+	}
+      else
+	demangled_name = symbol_find_demangled_name (gsymbol,
+						     linkage_name_copy);
+      demangled_len = demangled_name ? strlen (demangled_name) : 0;
 
       /* Suppose we have demangled_name==NULL, copy_name==0, and
 	 lookup_name==linkage_name.  In this case, we already have the
@@ -993,6 +1017,7 @@ symbol_set_names (struct general_symbol_info *gsymbol,
 			       &per_bfd->storage_obstack);
   else
     symbol_set_demangled_name (gsymbol, NULL, &per_bfd->storage_obstack);
+  xfree (cplus_demangled);
 }
 
 /* Return the source code name of a symbol.  In languages where
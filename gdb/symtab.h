@@ -213,6 +213,16 @@ extern void symbol_set_names (struct general_symbol_info *symbol,
 			      const char *linkage_name, int len, int copy_name,
 			      struct objfile *objfile);
 
+/* Like symbol_set_names, but if CPLUS_DEMANGLED is not NULL, it is the
+   C++ demangling of LINKAGE_NAME, already computed by the caller, and
+   is used instead of demangling LINKAGE_NAME again.  CPLUS_DEMANGLED
+   must be malloced; this function takes ownership of it.  */
+
+extern void symbol_set_names_cplus (struct general_symbol_info *symbol,
+				    const char *linkage_name, int len,
+				    int copy_name, struct objfile *objfile,
+				    char *cplus_demangled);
+
 /* Now come lots of name accessor macros.  Short version as to when to
    use which: Use SYMBOL_NATURAL_NAME to refer to the name of the
    symbol in the original source code.  Use SYMBOL_LINKAGE_NAME if you
@@ -362,6 +372,11 @@ struct minimal_symbol
      the object file format may not carry that piece of information.  */
   unsigned int has_size : 1;
 
+  /* Nonzero if only the linkage name of this symbol has been recorded
+     so far, and its demangled name remains to be computed when the
+     minimal symbols are installed.  See install_minimal_symbols.  */
+  unsigned int names_pending : 1;
+
   /* Minimal symbols with the same hash key are kept on a linked
      list.  This is the link.  */
 
@@ -106,6 +106,8 @@
   target_debug_do_print (host_address_to_string (X))
 #define target_debug_print_struct_target_section_table_p(X)	\
   target_debug_do_print (host_address_to_string (X))
+#define target_debug_print_struct_memory_read_request_p(X)	\
+  target_debug_do_print (host_address_to_string (X))
 #define target_debug_print_async_callback_ftype_p(X) \
   target_debug_do_print (host_address_to_string (X))
 #define target_debug_print_void_p(X) \
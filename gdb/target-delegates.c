@@ -2072,6 +2072,32 @@ debug_memory_map (struct target_ops *self)
   return result;
 }
 
+static void
+delegate_read_memory_batch (struct target_ops *self, struct memory_read_request *arg1, int arg2)
+{
+  self = self->beneath;
+  self->to_read_memory_batch (self, arg1, arg2);
+}
+
+static void
+tdefault_read_memory_batch (struct target_ops *self, struct memory_read_request *arg1, int arg2)
+{
+}
+
+static void
+debug_read_memory_batch (struct target_ops *self, struct memory_read_request *arg1, int arg2)
+{
+  fprintf_unfiltered (gdb_stdlog, "-> %s->to_read_memory_batch (...)\n", debug_target.to_shortname);
+  debug_target.to_read_memory_batch (&debug_target, arg1, arg2);
+  fprintf_unfiltered (gdb_stdlog, "<- %s->to_read_memory_batch (", debug_target.to_shortname);
+  target_debug_print_struct_target_ops_p (&debug_target);
+  fputs_unfiltered (", ", gdb_stdlog);
+  target_debug_print_struct_memory_read_request_p (arg1);
+  fputs_unfiltered (", ", gdb_stdlog);
+  target_debug_print_int (arg2);
+  fputs_unfiltered (")\n", gdb_stdlog);
+}
+
 static void
 delegate_flash_erase (struct target_ops *self, ULONGEST arg1, LONGEST arg2)
 {
@@ -4204,6 +4230,8 @@ install_delegators (struct target_ops *ops)
     ops->to_xfer_partial = delegate_xfer_partial;
   if (ops->to_memory_map == NULL)
     ops->to_memory_map = delegate_memory_map;
+  if (ops->to_read_memory_batch == NULL)
+    ops->to_read_memory_batch = delegate_read_memory_batch;
   if (ops->to_flash_erase == NULL)
     ops->to_flash_erase = delegate_flash_erase;
   if (ops->to_flash_done == NULL)
@@ -4433,6 +4461,7 @@ install_dummy_methods (struct target_ops *ops)
   ops->to_get_thread_local_address = tdefault_get_thread_local_address;
   ops->to_xfer_partial = tdefault_xfer_partial;
   ops->to_memory_map = tdefault_memory_map;
+  ops->to_read_memory_batch = tdefault_read_memory_batch;
   ops->to_flash_erase = tdefault_flash_erase;
   ops->to_flash_done = tdefault_flash_done;
   ops->to_read_description = tdefault_read_description;
@@ -4588,6 +4617,7 @@ init_debug_target (struct target_ops *ops)
   ops->to_get_thread_local_address = debug_get_thread_local_address;
   ops->to_xfer_partial = debug_xfer_partial;
   ops->to_memory_map = debug_memory_map;
+  ops->to_read_memory_batch = debug_read_memory_batch;
   ops->to_flash_erase = debug_flash_erase;
   ops->to_flash_done = debug_flash_done;
   ops->to_read_description = debug_read_description;
@@ -990,17 +990,11 @@ struct target_section *
 target_section_by_addr (struct target_ops *target, CORE_ADDR addr)
 {
   struct target_section_table *table = target_get_section_table (target);
-  struct target_section *secp;
 
   if (table == NULL)
     return NULL;
 
-  for (secp = table->sections; secp < table->sections_end; secp++)
-    {
-      if (addr >= secp->addr && addr < secp->endaddr)
-	return secp;
-    }
-  return NULL;
+  return section_table_find (table, addr, NULL);
 }
 
 
@@ -1136,9 +1130,7 @@ memory_xfer_partial_1 (struct target_ops *ops, enum target_object object,
 	  memaddr = overlay_mapped_address (memaddr, section);
 	  return section_table_xfer_memory_partial (readbuf, writebuf,
 						    memaddr, len, xfered_len,
-						    table->sections,
-						    table->sections_end,
-						    section_name);
+						    table, section_name);
 	}
     }
 
@@ -1157,9 +1149,7 @@ memory_xfer_partial_1 (struct target_ops *ops, enum target_object object,
 	  table = target_get_section_table (ops);
 	  return section_table_xfer_memory_partial (readbuf, writebuf,
 						    memaddr, len, xfered_len,
-						    table->sections,
-						    table->sections_end,
-						    NULL);
+						    table, NULL);
 	}
     }
 
@@ -1464,6 +1454,65 @@ target_read_code (CORE_ADDR memaddr, gdb_byte *myaddr, ssize_t len)
     return TARGET_XFER_E_IO;
 }
 
+/* See target.h.  */
+
+void
+target_read_memory_batch (struct memory_read_request *requests, int count)
+{
+  int i;
+
+  for (i = 0; i < count; i++)
+    requests[i].status = TARGET_XFER_E_IO;
+
+  /* Let the target read as much as it can in one go, bypassing the
+     per-block checks done by memory_xfer_partial.  Only do that when
+     those checks could not redirect the read elsewhere: not when
+     looking at a trace frame or replaying a recording, and not for
+     overlays or read-only sections read from the executable.  */
+  if (!ptid_equal (inferior_ptid, null_ptid)
+      && get_traceframe_number () == -1
+      && !target_record_is_replaying (inferior_ptid)
+      && !overlay_debugging
+      && !trust_readonly)
+    {
+      current_target.to_read_memory_batch (&current_target, requests, count);
+
+      for (i = 0; i < count; i++)
+	{
+	  struct memory_read_request *req = &requests[i];
+	  struct mem_region *region;
+	  ULONGEST reg_len;
+
+	  if (req->status != TARGET_XFER_OK)
+	    continue;
+
+	  /* If the memory attributes would not have allowed reading
+	     the whole block, let target_read_memory sort it out.  */
+	  if (!memory_xfer_check_region (req->buf, NULL, req->addr, req->len,
+					 &reg_len, &region)
+	      || reg_len != req->len)
+	    {
+	      req->status = TARGET_XFER_E_IO;
+	      continue;
+	    }
+
+	  if (!show_memory_breakpoints)
+	    breakpoint_xfer_memory (req->buf, NULL, NULL, req->addr,
+				    req->len);
+	}
+    }
+
+  for (i = 0; i < count; i++)
+    {
+      struct memory_read_request *req = &requests[i];
+
+      if (req->status != TARGET_XFER_OK)
+	req->status
+	  = (enum target_xfer_status) target_read_memory (req->addr, req->buf,
+							  req->len);
+    }
+}
+
 /* Write LEN bytes from MYADDR to target memory at address MEMADDR.
    Returns either 0 for success or TARGET_XFER_E_IO if any
    error occurs.  If an error occurs, no guarantee is made about how
@@ -2341,7 +2390,13 @@ target_read_description (struct target_ops *target)
 
 /* This implements a basic search of memory, reading target memory and
    performing the search here (as opposed to performing the search in on the
-   target side with, for example, gdbserver).  */
+   target side with, for example, gdbserver).
+
+   Memory is read in chunks.  The first chunk is small, since "find"
+   restarts the search right after each match and matches are often
+   close together; each chunk searched without a match doubles the
+   size of the next one, so that long searches are done with few large
+   target reads.  */
 
 int
 simple_search_memory (struct target_ops *ops,
@@ -2351,13 +2406,17 @@ simple_search_memory (struct target_ops *ops,
 {
   /* NOTE: also defined in find.c testcase.  */
 #define SEARCH_CHUNK_SIZE 16000
-  const unsigned chunk_size = SEARCH_CHUNK_SIZE;
+#define SEARCH_MAX_CHUNK_SIZE (1024 * 1024)
+  ULONGEST chunk_size = SEARCH_CHUNK_SIZE;
   /* Buffer to hold memory contents for searching.  */
   gdb_byte *search_buf;
-  unsigned search_buf_size;
+  ULONGEST search_buf_size;
+  /* The number of bytes at the start of SEARCH_BUF kept from the
+     previous chunk.  */
+  ULONGEST keep_len = 0;
   struct cleanup *old_cleanups;
 
-  search_buf_size = chunk_size + pattern_len - 1;
+  search_buf_size = SEARCH_MAX_CHUNK_SIZE + pattern_len - 1;
 
   /* No point in trying to allocate a buffer larger than the search space.  */
   if (search_space_len < search_buf_size)
@@ -2368,28 +2427,31 @@ simple_search_memory (struct target_ops *ops,
     error (_("Unable to allocate memory to perform the search."));
   old_cleanups = make_cleanup (free_current_contents, &search_buf);
 
-  /* Prime the search buffer.  */
-
-  if (target_read (ops, TARGET_OBJECT_MEMORY, NULL,
-		   search_buf, start_addr, search_buf_size) != search_buf_size)
-    {
-      warning (_("Unable to access %s bytes of target "
-		 "memory at %s, halting search."),
-	       pulongest (search_buf_size), hex_string (start_addr));
-      do_cleanups (old_cleanups);
-      return -1;
-    }
-
   /* Perform the search.
 
-     The loop is kept simple by allocating [N + pattern-length - 1] bytes.
-     When we've scanned N bytes we copy the trailing bytes to the start and
-     read in another N bytes.  */
+     Each iteration searches [N + pattern-length - 1] bytes.  When we've
+     scanned N bytes without a match, we copy the trailing bytes to the
+     start of the buffer and read in the next chunk after them.  */
 
   while (search_space_len >= pattern_len)
     {
       gdb_byte *found_ptr;
-      unsigned nr_search_bytes = min (search_space_len, search_buf_size);
+      ULONGEST nr_search_bytes = min (search_space_len,
+				      chunk_size + pattern_len - 1);
+      ULONGEST nr_to_read = nr_search_bytes - keep_len;
+      CORE_ADDR read_addr = start_addr + keep_len;
+      ULONGEST advance;
+
+      if (target_read (ops, TARGET_OBJECT_MEMORY, NULL,
+		       search_buf + keep_len, read_addr,
+		       nr_to_read) != nr_to_read)
+	{
+	  warning (_("Unable to access %s bytes of target "
+		     "memory at %s, halting search."),
+		   pulongest (nr_to_read), hex_string (read_addr));
+	  do_cleanups (old_cleanups);
+	  return -1;
+	}
 
       found_ptr = memmem (search_buf, nr_search_bytes,
 			  pattern, pattern_len);
@@ -2405,39 +2467,21 @@ simple_search_memory (struct target_ops *ops,
 
       /* Not found in this chunk, skip to next chunk.  */
 
-      /* Don't let search_space_len wrap here, it's unsigned.  */
-      if (search_space_len >= chunk_size)
-	search_space_len -= chunk_size;
-      else
-	search_space_len = 0;
-
-      if (search_space_len >= pattern_len)
-	{
-	  unsigned keep_len = search_buf_size - chunk_size;
-	  CORE_ADDR read_addr = start_addr + chunk_size + keep_len;
-	  int nr_to_read;
-
-	  /* Copy the trailing part of the previous iteration to the front
-	     of the buffer for the next iteration.  */
-	  gdb_assert (keep_len == pattern_len - 1);
-	  memcpy (search_buf, search_buf + chunk_size, keep_len);
+      if (nr_search_bytes == search_space_len)
+	break;
 
-	  nr_to_read = min (search_space_len - keep_len, chunk_size);
+      /* Copy the trailing part of this iteration, which may hold the
+	 start of a match, to the front of the buffer for the next
+	 iteration.  */
+      advance = nr_search_bytes - (pattern_len - 1);
+      keep_len = pattern_len - 1;
+      memmove (search_buf, search_buf + advance, keep_len);
 
-	  if (target_read (ops, TARGET_OBJECT_MEMORY, NULL,
-			   search_buf + keep_len, read_addr,
-			   nr_to_read) != nr_to_read)
-	    {
-	      warning (_("Unable to access %s bytes of target "
-			 "memory at %s, halting search."),
-		       plongest (nr_to_read),
-		       hex_string (read_addr));
-	      do_cleanups (old_cleanups);
-	      return -1;
-	    }
+      start_addr += advance;
+      search_space_len -= advance;
 
-	  start_addr += chunk_size;
-	}
+      if (chunk_size < SEARCH_MAX_CHUNK_SIZE)
+	chunk_size = min (chunk_size * 2, SEARCH_MAX_CHUNK_SIZE);
     }
 
   /* Not found.  */
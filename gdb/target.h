@@ -301,6 +301,22 @@ DEF_VEC_O(memory_read_result_s);
 
 extern void free_memory_read_result_vector (void *);
 
+/* Describes a request for a memory read operation, for
+   target_read_memory_batch.  */
+
+struct memory_read_request
+  {
+    /* The address to read from.  */
+    CORE_ADDR addr;
+    /* The number of bytes to read.  */
+    ULONGEST len;
+    /* Where to store the data.  */
+    gdb_byte *buf;
+    /* TARGET_XFER_OK if the whole block was read, or an error
+       status otherwise.  */
+    enum target_xfer_status status;
+  };
+
 extern VEC(memory_read_result_s)* read_memory_robust (struct target_ops *ops,
 						      const ULONGEST offset,
 						      const LONGEST len);
@@ -757,6 +773,18 @@ struct target_ops
     VEC(mem_region_s) *(*to_memory_map) (struct target_ops *)
       TARGET_DEFAULT_RETURN (NULL);
 
+    /* Read several blocks of memory at once, preferably with a single
+       request to the target.  REQUESTS points to COUNT read requests.
+       Set the STATUS of each request that was read completely to
+       TARGET_XFER_OK; leave the others alone.  This reads raw memory:
+       callers should use target_read_memory_batch, which takes care
+       of breakpoint shadows and of the requests the target could not
+       read.  */
+    void (*to_read_memory_batch) (struct target_ops *,
+				  struct memory_read_request *requests,
+				  int count)
+      TARGET_DEFAULT_IGNORE ();
+
     /* Erases the region of flash memory starting at ADDRESS, of
        length LENGTH.
 
@@ -1416,6 +1444,15 @@ extern int target_read_stack (CORE_ADDR memaddr, gdb_byte *myaddr, ssize_t len);
 
 extern int target_read_code (CORE_ADDR memaddr, gdb_byte *myaddr, ssize_t len);
 
+/* Read the COUNT blocks of memory described by REQUESTS, setting the
+   STATUS of each.  This is equivalent to calling target_read_memory
+   for each request, but lets the target satisfy many small reads with
+   one request (for instance, a single system call on native
+   GNU/Linux).  */
+
+extern void target_read_memory_batch (struct memory_read_request *requests,
+				      int count);
+
 /* For target_write_memory see target/target.h.  */
 
 extern int target_write_raw_memory (CORE_ADDR memaddr, const gdb_byte *myaddr,
@@ -2324,6 +2361,15 @@ struct target_section_table
 {
   struct target_section *sections;
   struct target_section *sections_end;
+
+  /* An index of SECTIONS, sorted by address, built on demand by
+     section_table_find and discarded whenever SECTIONS changes.  NULL
+     if not built yet.  */
+  struct target_section **sorted;
+
+  /* MAX_ENDADDR[I] is the highest end address of SORTED[0] to
+     SORTED[I].  */
+  CORE_ADDR *max_endaddr;
 };
 
 /* Return the "section" containing the specified address.  */
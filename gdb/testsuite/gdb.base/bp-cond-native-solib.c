@@ -0,0 +1,45 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright (C) 2015 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <stddef.h>
+#include <dlfcn.h>
+
+int
+main (void)
+{
+  int round, i;
+
+  for (round = 0; round < 2; round++)
+    {
+      void *handle = dlopen (SHLIB_NAME, RTLD_LAZY);
+      int (*func) (int, int);
+
+      if (handle == NULL)
+	return 1;
+
+      func = (int (*) (int, int)) dlsym (handle, "lib_func");
+      if (func == NULL)
+	return 1;
+
+      for (i = 0; i < 100; i++)
+	func (round, i);
+
+      dlclose (handle);
+    }
+
+  return 0;
+}
@@ -0,0 +1,39 @@
+/* Copyright (C) 2015 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* A buffer that is mostly zero, with a few non-zero bytes scattered
+   over pages of its own, and one at the very end.  */
+
+#define BUFFER_SIZE (4 * 1024 * 1024)
+
+char buffer[BUFFER_SIZE];
+
+static void
+break_here (void)
+{
+}
+
+int
+main (void)
+{
+  buffer[0] = 1;
+  buffer[BUFFER_SIZE / 2 + 123] = 2;
+  buffer[BUFFER_SIZE - 1] = 3;
+
+  break_here ();
+  return 0;
+}
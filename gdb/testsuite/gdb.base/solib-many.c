@@ -0,0 +1,55 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright (C) 2015 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <stdio.h>
+#include <dlfcn.h>
+
+static void *handles[NUM_LIBS];
+
+static void
+all_loaded (void)
+{
+}
+
+static void
+odd_unloaded (void)
+{
+}
+
+int
+main (void)
+{
+  char name[1024];
+  int i;
+
+  for (i = 0; i < NUM_LIBS; i++)
+    {
+      snprintf (name, sizeof name, "%s/solib-many-lib%d.so", SHLIB_DIR, i);
+      handles[i] = dlopen (name, RTLD_LAZY);
+      if (handles[i] == NULL)
+	return 1;
+    }
+
+  all_loaded ();
+
+  for (i = 1; i < NUM_LIBS; i += 2)
+    dlclose (handles[i]);
+
+  odd_unloaded ();
+
+  return 0;
+}
@@ -0,0 +1,34 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright (C) 2015 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+struct many
+{
+  int f0, f1, f2, f3, f4, f5, f6, f7;
+  int f8, f9, f10, f11, f12, f13, f14, f15;
+};
+
+struct many s;
+
+int
+main (void)
+{
+  s.f3 = 3;
+  s.f12 = 12;	/* first update */
+  s.f3 = 10;	/* second update */
+  s.f3 = 10;	/* third update */
+  return 0;	/* fourth update */
+}
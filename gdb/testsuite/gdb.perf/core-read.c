@@ -0,0 +1,60 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright (C) 2015 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <sys/mman.h>
+#include <unistd.h>
+#include <string.h>
+
+#ifndef NUM_REGIONS
+#define NUM_REGIONS 1000
+#endif
+
+/* The start of each mapping, so that GDB can read them back.  */
+char *regions[NUM_REGIONS];
+
+static void
+marker (void)
+{
+}
+
+int
+main (void)
+{
+  long page = sysconf (_SC_PAGESIZE);
+  char *base;
+  int i;
+
+  /* Reserve twice the space needed, and leave every other page
+     inaccessible, so that the kernel doesn't merge the mappings and
+     the core file gets one load segment per region.  */
+  base = mmap (NULL, 2 * NUM_REGIONS * page, PROT_NONE,
+	       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (base == MAP_FAILED)
+    return 1;
+
+  for (i = 0; i < NUM_REGIONS; i++)
+    {
+      regions[i] = base + 2 * i * page;
+      if (mprotect (regions[i], page, PROT_READ | PROT_WRITE) != 0)
+	return 1;
+      memset (regions[i], i & 0xff, page);
+    }
+
+  marker ();
+
+  return 0;
+}
@@ -0,0 +1,39 @@
+# Copyright (C) 2015 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+from perftest import perftest
+
+class CoreRead (perftest.TestCaseWithBasicMeasurements):
+    def __init__(self, num_regions, count):
+        super (CoreRead, self).__init__ ("core-read")
+        self.num_regions = num_regions
+        self.count = count
+
+    def warm_up(self):
+        self.regions = []
+        regions = gdb.parse_and_eval("regions")
+        for i in range(0, self.num_regions):
+            self.regions.append(int(regions[i]))
+
+    def _run(self, r):
+        inferior = gdb.selected_inferior()
+        for _ in range(0, r):
+            for addr in self.regions:
+                inferior.read_memory(addr, 4096)
+
+    def execute_test(self):
+        for i in range(1, 5):
+            func = lambda: self._run(i * self.count)
+            self.measure.measure(func, i * self.count)
@@ -0,0 +1,39 @@
+# Copyright (C) 2015 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+from perftest import perftest
+
+class ManyBreakpoints (perftest.TestCaseWithBasicMeasurements):
+    def __init__(self, num_funcs):
+        super (ManyBreakpoints, self).__init__ ("many-breakpoints")
+        self.num_funcs = num_funcs
+
+    def warm_up(self):
+        self.filename = gdb.current_progspace().filename
+        # Read the symbols before measuring.
+        gdb.execute("info functions ^func_0$", to_string=True)
+
+    def _run(self, r):
+        for _ in range(0, r):
+            gdb.execute("rbreak ^func_", to_string=True)
+            # Reloading the symbols re-sets all the breakpoints, as
+            # loading a shared library does.
+            gdb.execute("symbol-file %s" % self.filename, to_string=True)
+            gdb.execute("delete", to_string=True)
+
+    def execute_test(self):
+        for i in range(1, 4):
+            func = lambda: self._run(i)
+            self.measure.measure(func, i)
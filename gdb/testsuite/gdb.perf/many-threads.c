@@ -0,0 +1,66 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright (C) 2015 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <pthread.h>
+#include <unistd.h>
+#include <limits.h>
+
+#ifndef NUM_THREADS
+#define NUM_THREADS 1000
+#endif
+
+static pthread_barrier_t barrier;
+
+static void *
+thread_function (void *arg)
+{
+  pthread_barrier_wait (&barrier);
+
+  while (1)
+    sleep (10);
+
+  return NULL;
+}
+
+static void
+marker (void)
+{
+}
+
+int
+main (void)
+{
+  pthread_attr_t attr;
+  pthread_t thread;
+  int i;
+
+  pthread_barrier_init (&barrier, NULL, NUM_THREADS + 1);
+
+  /* Keep the threads small, so that many of them fit.  */
+  pthread_attr_init (&attr);
+  pthread_attr_setstacksize (&attr, PTHREAD_STACK_MIN * 2);
+
+  for (i = 0; i < NUM_THREADS; i++)
+    pthread_create (&thread, &attr, thread_function, NULL);
+
+  pthread_barrier_wait (&barrier);
+
+  while (1)
+    marker ();
+
+  return 0;
+}
@@ -43,6 +43,7 @@
 #include "gdb_regex.h"
 #include "cli/cli-utils.h"
 #include "thread-fsm.h"
+#include "hashtab.h"
 
 /* Definition of struct thread_info exported to gdbthread.h.  */
 
@@ -62,6 +63,204 @@ static int highest_thread_num;
    spawned new threads we haven't heard of yet.  */
 static int threads_executing;
 
+/* Hash table of the threads in THREAD_LIST, keyed by ptid.  Each slot
+   holds the most recently added thread with that ptid; older threads
+   with the same ptid are chained through their next_same_ptid
+   field.  */
+static htab_t thread_ptid_htab;
+
+/* The threads of one process, most recently added first.  */
+
+struct process_threads
+{
+  int pid;
+  struct thread_info *threads;
+};
+
+/* Hash table of struct process_threads, keyed by pid.  */
+static htab_t process_threads_htab;
+
+/* Hash function for PTID.  */
+
+static hashval_t
+hash_ptid (ptid_t ptid)
+{
+  hashval_t hash = ptid_get_pid (ptid);
+
+  hash = hash * 31 + (hashval_t) ptid_get_lwp (ptid);
+  return hash * 31 + (hashval_t) ptid_get_tid (ptid);
+}
+
+/* Hash function for a thread_info in THREAD_PTID_HTAB.  */
+
+static hashval_t
+hash_thread_ptid (const void *p)
+{
+  const struct thread_info *tp = (const struct thread_info *) p;
+
+  return hash_ptid (tp->ptid);
+}
+
+/* Equality function for THREAD_PTID_HTAB.  The key is a pointer to a
+   ptid.  */
+
+static int
+eq_thread_ptid (const void *a, const void *b)
+{
+  const struct thread_info *tp = (const struct thread_info *) a;
+  const ptid_t *ptid = (const ptid_t *) b;
+
+  return ptid_equal (tp->ptid, *ptid);
+}
+
+/* Hash function for PROCESS_THREADS_HTAB.  */
+
+static hashval_t
+hash_process_threads (const void *p)
+{
+  const struct process_threads *procs = (const struct process_threads *) p;
+
+  return procs->pid;
+}
+
+/* Equality function for PROCESS_THREADS_HTAB.  */
+
+static int
+eq_process_threads (const void *a, const void *b)
+{
+  const struct process_threads *lhs = (const struct process_threads *) a;
+  const struct process_threads *rhs = (const struct process_threads *) b;
+
+  return lhs->pid == rhs->pid;
+}
+
+/* Add TP to THREAD_PTID_HTAB and to the thread list of its
+   process.  */
+
+static void
+thread_index_add (struct thread_info *tp)
+{
+  struct process_threads key, *procs;
+  void **slot;
+
+  slot = htab_find_slot_with_hash (thread_ptid_htab, &tp->ptid,
+				   hash_ptid (tp->ptid), INSERT);
+  tp->next_same_ptid = (struct thread_info *) *slot;
+  *slot = tp;
+
+  key.pid = ptid_get_pid (tp->ptid);
+  slot = htab_find_slot (process_threads_htab, &key, INSERT);
+  if (*slot == NULL)
+    {
+      procs = XNEW (struct process_threads);
+      procs->pid = key.pid;
+      procs->threads = NULL;
+      *slot = procs;
+    }
+  else
+    procs = (struct process_threads *) *slot;
+
+  tp->prev_in_process = NULL;
+  tp->next_in_process = procs->threads;
+  if (procs->threads != NULL)
+    procs->threads->prev_in_process = tp;
+  procs->threads = tp;
+}
+
+/* Remove TP from THREAD_PTID_HTAB and from the thread list of its
+   process.  */
+
+static void
+thread_index_remove (struct thread_info *tp)
+{
+  struct process_threads key, *procs;
+  struct thread_info *it;
+  void **slot;
+
+  slot = htab_find_slot_with_hash (thread_ptid_htab, &tp->ptid,
+				   hash_ptid (tp->ptid), NO_INSERT);
+  gdb_assert (slot != NULL);
+  if (*slot == tp)
+    {
+      if (tp->next_same_ptid != NULL)
+	*slot = tp->next_same_ptid;
+      else
+	htab_clear_slot (thread_ptid_htab, slot);
+    }
+  else
+    {
+      for (it = (struct thread_info *) *slot;
+	   it->next_same_ptid != tp;
+	   it = it->next_same_ptid)
+	gdb_assert (it->next_same_ptid != NULL);
+      it->next_same_ptid = tp->next_same_ptid;
+    }
+  tp->next_same_ptid = NULL;
+
+  key.pid = ptid_get_pid (tp->ptid);
+  slot = htab_find_slot (process_threads_htab, &key, NO_INSERT);
+  gdb_assert (slot != NULL);
+  procs = (struct process_threads *) *slot;
+
+  if (tp->next_in_process != NULL)
+    tp->next_in_process->prev_in_process = tp->prev_in_process;
+  if (tp->prev_in_process != NULL)
+    tp->prev_in_process->next_in_process = tp->next_in_process;
+  else
+    procs->threads = tp->next_in_process;
+  tp->next_in_process = tp->prev_in_process = NULL;
+
+  if (procs->threads == NULL)
+    htab_clear_slot (process_threads_htab, slot);
+}
+
+/* Change the ptid of TP to PTID, keeping the thread indexes up to
+   date.  */
+
+static void
+set_thread_ptid (struct thread_info *tp, ptid_t ptid)
+{
+  thread_index_remove (tp);
+  tp->ptid = ptid;
+  thread_index_add (tp);
+}
+
+/* See gdbthread.h.  */
+
+struct thread_info *
+process_thread_list (int pid)
+{
+  struct process_threads key, *procs;
+
+  key.pid = pid;
+  procs = (struct process_threads *) htab_find (process_threads_htab, &key);
+  return procs != NULL ? procs->threads : NULL;
+}
+
+/* Return the first of the threads matching PTID, which is either
+   MINUS_ONE_PTID or a process ptid.  In the latter case, only the
+   threads of that process are visited.  Use next_thread_matching to
+   continue the walk.  */
+
+static struct thread_info *
+first_thread_matching (ptid_t ptid)
+{
+  if (ptid_equal (ptid, minus_one_ptid))
+    return thread_list;
+  return process_thread_list (ptid_get_pid (ptid));
+}
+
+/* Return the thread following TP in a walk started with
+   first_thread_matching (PTID).  */
+
+static struct thread_info *
+next_thread_matching (struct thread_info *tp, ptid_t ptid)
+{
+  if (ptid_equal (ptid, minus_one_ptid))
+    return tp->next;
+  return tp->next_in_process;
+}
+
 static void thread_apply_all_command (char *, int);
 static int thread_alive (struct thread_info *);
 static void info_threads_command (char *, int);
@@ -223,6 +422,8 @@ init_thread_list (void)
     }
 
   thread_list = NULL;
+  htab_empty (thread_ptid_htab);
+  htab_empty (process_threads_htab);
   threads_executing = 0;
 }
 
@@ -237,7 +438,10 @@ new_thread (ptid_t ptid)
   tp->ptid = ptid;
   tp->num = ++highest_thread_num;
   tp->next = thread_list;
+  if (thread_list != NULL)
+    thread_list->prev = tp;
   thread_list = tp;
+  thread_index_add (tp);
 
   /* Nothing to follow yet.  */
   tp->pending_follow.kind = TARGET_WAITKIND_SPURIOUS;
@@ -278,7 +482,7 @@ add_thread_silent (ptid_t ptid)
 	  delete_thread (ptid);
 
 	  /* Now reset its ptid, and reswitch inferior_ptid to it.  */
-	  tp->ptid = ptid;
+	  set_thread_ptid (tp, ptid);
 	  tp->state = THREAD_STOPPED;
 	  switch_to_thread (ptid);
 
@@ -403,14 +607,9 @@ thread_step_over_chain_remove (struct thread_info *tp)
 static void
 delete_thread_1 (ptid_t ptid, int silent)
 {
-  struct thread_info *tp, *tpprev;
-
-  tpprev = NULL;
-
-  for (tp = thread_list; tp; tpprev = tp, tp = tp->next)
-    if (ptid_equal (tp->ptid, ptid))
-      break;
+  struct thread_info *tp;
 
+  tp = find_thread_ptid (ptid);
   if (!tp)
     return;
 
@@ -447,10 +646,13 @@ delete_thread_1 (ptid_t ptid, int silent)
   tp->state = THREAD_EXITED;
   clear_thread_inferior_resources (tp);
 
-  if (tpprev)
-    tpprev->next = tp->next;
+  if (tp->next != NULL)
+    tp->next->prev = tp->prev;
+  if (tp->prev != NULL)
+    tp->prev->next = tp->next;
   else
     thread_list = tp->next;
+  thread_index_remove (tp);
 
   free_thread (tp);
 }
@@ -487,13 +689,8 @@ find_thread_id (int num)
 struct thread_info *
 find_thread_ptid (ptid_t ptid)
 {
-  struct thread_info *tp;
-
-  for (tp = thread_list; tp; tp = tp->next)
-    if (ptid_equal (tp->ptid, ptid))
-      return tp;
-
-  return NULL;
+  return ((struct thread_info *)
+	  htab_find_with_hash (thread_ptid_htab, &ptid, hash_ptid (ptid)));
 }
 
 /*
@@ -553,11 +750,10 @@ valid_thread_id (int num)
 int
 pid_to_thread_id (ptid_t ptid)
 {
-  struct thread_info *tp;
+  struct thread_info *tp = find_thread_ptid (ptid);
 
-  for (tp = thread_list; tp; tp = tp->next)
-    if (ptid_equal (tp->ptid, ptid))
-      return tp->num;
+  if (tp != NULL)
+    return tp->num;
 
   return 0;
 }
@@ -576,13 +772,7 @@ thread_id_to_pid (int num)
 int
 in_thread_list (ptid_t ptid)
 {
-  struct thread_info *tp;
-
-  for (tp = thread_list; tp; tp = tp->next)
-    if (ptid_equal (tp->ptid, ptid))
-      return 1;
-
-  return 0;			/* Never heard of 'im.  */
+  return find_thread_ptid (ptid) != NULL;
 }
 
 /* Finds the first thread of the inferior given by PID.  If PID is -1,
@@ -593,10 +783,13 @@ first_thread_of_process (int pid)
 {
   struct thread_info *tp, *ret = NULL;
 
-  for (tp = thread_list; tp; tp = tp->next)
-    if (pid == -1 || ptid_get_pid (tp->ptid) == pid)
-      if (ret == NULL || tp->num < ret->num)
-	ret = tp;
+  if (pid == -1)
+    tp = thread_list;
+  else
+    tp = process_thread_list (pid);
+  for (; tp; tp = (pid == -1 ? tp->next : tp->next_in_process))
+    if (ret == NULL || tp->num < ret->num)
+      ret = tp;
 
   return ret;
 }
@@ -612,8 +805,8 @@ any_thread_of_process (int pid)
   if (ptid_get_pid (inferior_ptid) == pid)
     return inferior_thread ();
 
-  ALL_NON_EXITED_THREADS (tp)
-    if (ptid_get_pid (tp->ptid) == pid)
+  ALL_THREADS_OF_PROCESS (pid, tp)
+    if (tp->state != THREAD_EXITED)
       return tp;
 
   return NULL;
@@ -858,7 +1051,7 @@ thread_change_ptid (ptid_t old_ptid, ptid_t new_ptid)
   inf->pid = ptid_get_pid (new_ptid);
 
   tp = find_thread_ptid (old_ptid);
-  tp->ptid = new_ptid;
+  set_thread_ptid (tp, new_ptid);
 
   observer_notify_thread_ptid_changed (old_ptid, new_ptid);
 }
@@ -873,9 +1066,9 @@ set_resumed (ptid_t ptid, int resumed)
 
   if (all || ptid_is_pid (ptid))
     {
-      for (tp = thread_list; tp; tp = tp->next)
-	if (all || ptid_get_pid (tp->ptid) == ptid_get_pid (ptid))
-	  tp->resumed = resumed;
+      for (tp = first_thread_matching (ptid); tp;
+	   tp = next_thread_matching (tp, ptid))
+	tp->resumed = resumed;
     }
   else
     {
@@ -921,15 +1114,15 @@ set_running (ptid_t ptid, int running)
      frontend.  Frontend is supposed to handle multiple *running just fine.  */
   if (all || ptid_is_pid (ptid))
     {
-      for (tp = thread_list; tp; tp = tp->next)
-	if (all || ptid_get_pid (tp->ptid) == ptid_get_pid (ptid))
-	  {
-	    if (tp->state == THREAD_EXITED)
-	      continue;
+      for (tp = first_thread_matching (ptid); tp;
+	   tp = next_thread_matching (tp, ptid))
+	{
+	  if (tp->state == THREAD_EXITED)
+	    continue;
 
-	    if (set_running_thread (tp, running))
-	      any_started = 1;
-	  }
+	  if (set_running_thread (tp, running))
+	    any_started = 1;
+	}
     }
   else
     {
@@ -989,9 +1182,9 @@ set_executing (ptid_t ptid, int executing)
 
   if (all || ptid_is_pid (ptid))
     {
-      for (tp = thread_list; tp; tp = tp->next)
-	if (all || ptid_get_pid (tp->ptid) == ptid_get_pid (ptid))
-	  tp->executing = executing;
+      for (tp = first_thread_matching (ptid); tp;
+	   tp = next_thread_matching (tp, ptid))
+	tp->executing = executing;
     }
   else
     {
@@ -1025,9 +1218,9 @@ set_stop_requested (ptid_t ptid, int stop)
 
   if (all || ptid_is_pid (ptid))
     {
-      for (tp = thread_list; tp; tp = tp->next)
-	if (all || ptid_get_pid (tp->ptid) == ptid_get_pid (ptid))
-	  tp->stop_requested = stop;
+      for (tp = first_thread_matching (ptid); tp;
+	   tp = next_thread_matching (tp, ptid))
+	tp->stop_requested = stop;
     }
   else
     {
@@ -1053,15 +1246,13 @@ finish_thread_state (ptid_t ptid)
 
   if (all || ptid_is_pid (ptid))
     {
-      for (tp = thread_list; tp; tp = tp->next)
+      for (tp = first_thread_matching (ptid); tp;
+	   tp = next_thread_matching (tp, ptid))
 	{
  	  if (tp->state == THREAD_EXITED)
   	    continue;
-	  if (all || ptid_get_pid (ptid) == ptid_get_pid (tp->ptid))
-	    {
-	      if (set_running_thread (tp, tp->executing))
-		any_started = 1;
-	    }
+	  if (set_running_thread (tp, tp->executing))
+	    any_started = 1;
 	}
     }
   else
@@ -1939,6 +2130,13 @@ _initialize_thread (void)
 {
   static struct cmd_list_element *thread_apply_list = NULL;
 
+  thread_ptid_htab = htab_create_alloc (127, hash_thread_ptid,
+					eq_thread_ptid, NULL,
+					xcalloc, xfree);
+  process_threads_htab = htab_create_alloc (7, hash_process_threads,
+					    eq_process_threads, xfree,
+					    xcalloc, xfree);
+
   add_info ("threads", info_threads_command, 
 	    _("Display currently known threads.\n\
 Usage: info threads [ID]...\n\
@@ -68,6 +68,7 @@
 #include "gdb_usleep.h"
 #include "interps.h"
 #include "gdb_regex.h"
+#include "worker-threads.h"
 
 #if !HAVE_DECL_MALLOC
 extern PTR malloc ();		/* ARI: PTR */
@@ -1061,6 +1062,9 @@ maybe_quit (void)
 void
 malloc_failure (long size)
 {
+  /* Errors can't be thrown from a worker thread.  */
+  worker_task_malloc_failure ();
+
   if (size > 0)
     {
       internal_error (__FILE__, __LINE__,
@@ -27,6 +27,7 @@
 
 #include "varobj.h"
 #include "vec.h"
+#include "target.h"
 #include "gdbthread.h"
 #include "inferior.h"
 #include "varobj-iter.h"
@@ -226,6 +227,10 @@ static struct varobj_root *rootlist;
 /* Pointer to the varobj hash table (built at run time).  */
 static struct vlist **varobj_table;
 
+/* The largest value varobj_update reads along with its siblings.
+   Larger values are read on their own, as before.  */
+#define VAROBJ_PREFETCH_MAX 4096
+
 
 
 /* API Implementation */
@@ -1610,6 +1615,98 @@ varobj_value_has_mutated (const struct varobj *var, struct value *new_value,
     return 0;
 }
 
+/* Return non-zero if the new value VALUE of VAR is one that
+   install_new_value will fetch, and that can be read from memory
+   along with the values of its siblings.  */
+
+static int
+varobj_prefetchable_p (const struct varobj *var, struct value *value)
+{
+  const struct varobj *v;
+  struct type *type;
+
+  if (value == NULL || !value_lazy (value)
+      || VALUE_LVAL (value) != lval_memory
+      || value_bitsize (value) != 0)
+    return 0;
+
+  /* install_new_value reads the referenced value instead.  */
+  type = check_typedef (value_type (value));
+  if (TYPE_CODE (type) == TYPE_CODE_REF)
+    return 0;
+
+  type = check_typedef (value_enclosing_type (value));
+  if (TYPE_LENGTH (type) == 0 || TYPE_LENGTH (type) > VAROBJ_PREFETCH_MAX)
+    return 0;
+
+  /* Values of frozen varobjs are only read on explicit request.  */
+  for (v = var; v != NULL; v = v->parent)
+    if (v->frozen)
+      return 0;
+
+  return (var->dynamic->pretty_printer != NULL
+	  || varobj_value_is_changeable_p (var)
+	  || (var->type != NULL && TYPE_CODE (var->type) == TYPE_CODE_UNION));
+}
+
+/* Compute the new values of the COUNT varobjs in ENTRIES, which are
+   children of the same parent about to be updated by varobj_update,
+   and read the contents of the values install_new_value will fetch
+   with a single batched target read.  Values that can't be read that
+   way are left lazy; install_new_value reads them and reports any
+   error.  */
+
+static void
+varobj_prefetch_values (varobj_update_result *entries, int count)
+{
+  struct memory_read_request *requests;
+  struct value **values;
+  struct cleanup *cleanups;
+  int i, n = 0;
+
+  if (count == 0)
+    return;
+
+  requests = XNEWVEC (struct memory_read_request, count);
+  cleanups = make_cleanup (xfree, requests);
+  values = XNEWVEC (struct value *, count);
+  make_cleanup (xfree, values);
+
+  for (i = 0; i < count; i++)
+    {
+      varobj_update_result *r = &entries[i];
+      struct varobj *v = r->varobj;
+      struct value *value = value_of_child (v->parent, v->index);
+
+      r->value = value;
+      r->value_computed = 1;
+
+      if (varobj_prefetchable_p (v, value))
+	{
+	  struct type *type = check_typedef (value_enclosing_type (value));
+
+	  /* This matches what value_fetch_lazy reads.  */
+	  requests[n].addr = value_address (value);
+	  requests[n].len = TYPE_LENGTH (type);
+	  requests[n].buf = value_contents_all_raw (value);
+	  values[n] = value;
+	  n++;
+	}
+    }
+
+  /* A single value gains nothing from batching.  */
+  if (n > 1)
+    {
+      target_read_memory_batch (requests, n);
+
+      for (i = 0; i < n; i++)
+	if (requests[i].status == TARGET_XFER_OK)
+	  set_value_lazy (values[i], 0);
+    }
+
+  do_cleanups (cleanups);
+}
+
 /* Update the values for a variable and its children.  This is a
    two-pronged attack.  First, re-parse the value for the root's
    expression to see if it's changed.  Then go all the way
@@ -1629,7 +1726,7 @@ VEC(varobj_update_result) *
 varobj_update (struct varobj **varp, int is_explicit)
 {
   int type_changed = 0;
-  int i;
+  int i, first_child;
   struct value *newobj;
   VEC (varobj_update_result) *stack = NULL;
   VEC (varobj_update_result) *result = NULL;
@@ -1707,7 +1804,10 @@ varobj_update (struct varobj **varp, int is_explicit)
 	{
 	  struct type *new_type;
 
-	  newobj = value_of_child (v->parent, v->index);
+	  if (r.value_computed)
+	    newobj = r.value;
+	  else
+	    newobj = value_of_child (v->parent, v->index);
 	  if (update_type_if_necessary(v, newobj))
 	    r.type_changed = 1;
 	  if (newobj)
@@ -1836,6 +1936,7 @@ varobj_update (struct varobj **varp, int is_explicit)
 	 child is popped from the work stack first, and so
 	 will be added to result first.  This does not
 	 affect correctness, just "nicer".  */
+      first_child = VEC_length (varobj_update_result, stack);
       for (i = VEC_length (varobj_p, v->children)-1; i >= 0; --i)
 	{
 	  varobj_p c = VEC_index (varobj_p, v->children, i);
@@ -1850,6 +1951,13 @@ varobj_update (struct varobj **varp, int is_explicit)
 	    }
 	}
 
+      /* Compute the values of the children now, so that their
+	 contents are read from the target in one go.  */
+      varobj_prefetch_values (VEC_address (varobj_update_result, stack)
+			      + first_child,
+			      VEC_length (varobj_update_result, stack)
+			      - first_child);
+
       if (r.changed || r.type_changed)
 	VEC_safe_push (varobj_update_result, result, &r);
     }
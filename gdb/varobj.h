@@ -71,6 +71,13 @@ typedef struct varobj_update_result_t
      be yet installed.  Don't use this outside varobj.c.  */
   int value_installed;  
 
+  /* These are used internally by varobj_update too.  If VALUE_COMPUTED
+     is set, VALUE is the new value of varobj, computed when its parent
+     was updated so that the values of siblings could be read from the
+     target together.  Don't use these outside varobj.c.  */
+  int value_computed;
+  struct value *value;
+
   /* This will be non-NULL when new children were added to the varobj.
      It lists the new children (which must necessarily come at the end
      of the child list) added during an update.  The caller is
@@ -0,0 +1,241 @@
+/* Running work on several threads.
+
+   Copyright (C) 2015 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "defs.h"
+#include "worker-threads.h"
+#include "gdbcmd.h"
+#include <unistd.h>
+#include <signal.h>
+#ifdef HAVE_PTHREAD_CREATE
+#include <pthread.h>
+#include <setjmp.h>
+#endif
+
+/* The number of threads to use for parallel work, counting the main
+   thread, as set by "maint set worker-threads".  -1 means one per
+   online processor; 0 and 1 mean that all work is done on the main
+   thread.  */
+
+static int worker_threads = -1;
+
+/* The most threads we start for one parallel_for_each call.  */
+
+#define MAX_WORKER_THREADS 64
+
+/* Implement "maint show worker-threads".  */
+
+static void
+show_worker_threads (struct ui_file *file, int from_tty,
+		     struct cmd_list_element *c, const char *value)
+{
+  if (worker_threads == -1)
+    fprintf_filtered (file, _("The number of worker threads is "
+			      "\"unlimited\" (currently %d).\n"),
+		      worker_threads_count ());
+  else
+    fprintf_filtered (file, _("The number of worker threads is %s.\n"),
+		      value);
+}
+
+/* See worker-threads.h.  */
+
+int
+worker_threads_count (void)
+{
+#ifdef HAVE_PTHREAD_CREATE
+  long count = worker_threads;
+
+  if (count == -1)
+    {
+#ifdef _SC_NPROCESSORS_ONLN
+      count = sysconf (_SC_NPROCESSORS_ONLN);
+#else
+      count = 1;
+#endif
+    }
+
+  if (count < 1)
+    return 1;
+  if (count > MAX_WORKER_THREADS)
+    return MAX_WORKER_THREADS;
+  return count;
+#else
+  return 1;
+#endif
+}
+
+#ifdef HAVE_PTHREAD_CREATE
+
+/* The key of the per-thread pointer to the jmp_buf that
+   worker_task_malloc_failure returns to, set while the thread runs a
+   task.  Only valid if WORKER_TASK_KEY_CREATED.  */
+
+static pthread_key_t worker_task_key;
+static int worker_task_key_created;
+
+#endif
+
+/* See worker-threads.h.  */
+
+void
+worker_task_malloc_failure (void)
+{
+#ifdef HAVE_PTHREAD_CREATE
+  if (worker_task_key_created)
+    {
+      jmp_buf *env = (jmp_buf *) pthread_getspecific (worker_task_key);
+
+      if (env != NULL)
+	longjmp (*env, 1);
+    }
+#endif
+}
+
+#ifdef HAVE_PTHREAD_CREATE
+
+/* The state shared by the threads of one parallel_for_each call.  */
+
+struct parallel_for_each_state
+{
+  /* The tasks to run.  */
+  int n;
+  parallel_for_each_ftype *func;
+  void *data;
+
+  /* The index of the next task to hand out, protected by LOCK.  */
+  int next;
+  pthread_mutex_t lock;
+};
+
+/* Run tasks from STATE until there are none left.  A task that runs
+   out of memory is abandoned, see worker_task_malloc_failure.  */
+
+static void
+parallel_for_each_run (struct parallel_for_each_state *state)
+{
+  jmp_buf env;
+
+  for (;;)
+    {
+      int i;
+
+      pthread_mutex_lock (&state->lock);
+      i = state->next++;
+      pthread_mutex_unlock (&state->lock);
+
+      if (i >= state->n)
+	break;
+      if (setjmp (env) == 0)
+	{
+	  pthread_setspecific (worker_task_key, &env);
+	  state->func (i, state->data);
+	}
+      pthread_setspecific (worker_task_key, NULL);
+    }
+}
+
+/* The start routine of the worker threads.  */
+
+static void *
+parallel_for_each_thread (void *arg)
+{
+  parallel_for_each_run ((struct parallel_for_each_state *) arg);
+  return NULL;
+}
+
+#endif
+
+/* See worker-threads.h.  */
+
+void
+parallel_for_each (int n, parallel_for_each_ftype *func, void *data)
+{
+  int nthreads = worker_threads_count ();
+  int i;
+
+  if (nthreads > n)
+    nthreads = n;
+
+#ifdef HAVE_PTHREAD_CREATE
+  if (nthreads > 1 && worker_task_key_created)
+    {
+      struct parallel_for_each_state state;
+      pthread_t threads[MAX_WORKER_THREADS];
+      sigset_t all_signals, old_mask;
+      int started = 0;
+
+      state.n = n;
+      state.func = func;
+      state.data = data;
+      state.next = 0;
+      pthread_mutex_init (&state.lock, NULL);
+
+      /* Signals such as SIGINT and SIGCHLD must keep being delivered
+	 to the main thread, so the workers start with all of them
+	 blocked.  */
+      sigfillset (&all_signals);
+      pthread_sigmask (SIG_SETMASK, &all_signals, &old_mask);
+      for (i = 1; i < nthreads; i++)
+	{
+	  if (pthread_create (&threads[started], NULL,
+			      parallel_for_each_thread, &state) != 0)
+	    break;
+	  started++;
+	}
+      pthread_sigmask (SIG_SETMASK, &old_mask, NULL);
+
+      /* The main thread does its share; if no thread could be
+	 started, it does everything.  */
+      parallel_for_each_run (&state);
+
+      for (i = 0; i < started; i++)
+	pthread_join (threads[i], NULL);
+      pthread_mutex_destroy (&state.lock);
+      return;
+    }
+#endif
+
+  for (i = 0; i < n; i++)
+    func (i, data);
+}
+
+/* Provide a prototype to silence -Wmissing-prototypes.  */
+extern initialize_file_ftype _initialize_worker_threads;
+
+void
+_initialize_worker_threads (void)
+{
+#ifdef HAVE_PTHREAD_CREATE
+  worker_task_key_created
+    = pthread_key_create (&worker_task_key, NULL) == 0;
+#endif
+
+  add_setshow_zuinteger_unlimited_cmd ("worker-threads", class_maintenance,
+				       &worker_threads, _("\
+Set the number of threads GDB uses for parallel work."), _("\
+Show the number of threads GDB uses for parallel work."), _("\
+Some slow operations, such as reading debug information, are split\n\
+into parts that run on several threads.  This sets how many threads,\n\
+counting GDB's main thread, may be used.  0 or 1 means that all work\n\
+is done on the main thread.  \"unlimited\" (the default) means one\n\
+thread per online processor."),
+				       NULL, show_worker_threads,
+				       &maintenance_set_cmdlist,
+				       &maintenance_show_cmdlist);
+}
@@ -0,0 +1,59 @@
+/* Running work on several threads.
+
+   Copyright (C) 2015 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef WORKER_THREADS_H
+#define WORKER_THREADS_H
+
+/* The type of a task run by parallel_for_each.  I is the index of
+   the task, DATA is the argument given to parallel_for_each.  */
+
+typedef void (parallel_for_each_ftype) (int i, void *data);
+
+/* Call FUNC (I, DATA) for every I from 0 to N - 1, spreading the calls
+   over the worker threads as set by "maint set worker-threads", and
+   return when all of them are done.  The calls may happen in any
+   order, and concurrently.
+
+   Most of GDB is not thread-safe, so FUNC must restrict itself to
+   reading shared data and writing data that belongs to task I.  In
+   particular it must not throw errors, use cleanups, print, issue
+   complaints, or allocate on shared obstacks.
+
+   FUNC may use xmalloc and xfree.  Since the cleanup chain is not
+   per-thread, running out of memory in a task must not throw as
+   malloc_failure normally does; instead, the task is abandoned by
+   longjmp'ing back here, leaking whatever it had allocated.  So FUNC
+   must store its results only once they are complete, and the caller
+   must cope with the results of some tasks being missing.  */
+
+extern void parallel_for_each (int n, parallel_for_each_ftype *func,
+			       void *data);
+
+/* Return the number of threads parallel_for_each uses, counting the
+   main thread.  This is 1 when there is no parallelism.  */
+
+extern int worker_threads_count (void);
+
+/* Called by malloc_failure.  If the current thread is running a task
+   of parallel_for_each on several threads, abandon the task; otherwise
+   return.  */
+
+extern void worker_task_malloc_failure (void);
+
+#endif /* WORKER_THREADS_H */
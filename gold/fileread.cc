@@ -435,6 +435,95 @@ File_read::read(off_t start, section_size_type size, void* p)
   this->do_read(start, size, p);
 }
 
+#ifdef HAVE_COPY_FILE_RANGE
+
+// A class used to ask the kernel once whether it supports
+// copy_file_range at all.  Sections are copied from several threads
+// when --threads is used, so the answer is computed under a Once
+// rather than cached in a variable which any thread may write.
+
+class Copy_file_range_probe : public Once
+{
+ public:
+  Copy_file_range_probe()
+    : is_supported_(false)
+  { }
+
+  // Return whether the kernel supports copy_file_range.
+  bool
+  is_supported()
+  {
+    this->run_once(NULL);
+    return this->is_supported_;
+  }
+
+ protected:
+  void
+  do_run_once(void*)
+  {
+    // A kernel with the system call rejects the bad descriptors with
+    // EBADF; only ENOSYS tells us that it is missing.
+    ssize_t ret = ::copy_file_range(-1, NULL, -1, NULL, 0, 0);
+    this->is_supported_ = ret >= 0 || errno != ENOSYS;
+  }
+
+ private:
+  bool is_supported_;
+};
+
+static Copy_file_range_probe copy_file_range_probe;
+
+#endif // defined(HAVE_COPY_FILE_RANGE)
+
+// Copy data from the file to the descriptor O.
+
+bool
+File_read::copy_to_descriptor(off_t start, section_size_type size, int o,
+			      off_t ostart)
+{
+#ifdef HAVE_COPY_FILE_RANGE
+  if (this->whole_file_view_ != NULL
+      || this->copy_file_range_failed_
+      || !copy_file_range_probe.is_supported())
+    return false;
+
+  this->reopen_descriptor();
+
+  loff_t in_off = start;
+  loff_t out_off = ostart;
+  size_t to_copy = size;
+  while (to_copy > 0)
+    {
+      ssize_t bytes = ::copy_file_range(this->descriptor_, &in_off, o,
+					&out_off, to_copy, 0);
+      if (bytes <= 0)
+	{
+	  // EXDEV, EOPNOTSUPP and EINVAL mean that the kernel can't
+	  // copy between this file and the output at all, typically
+	  // because they are on different or unsuitable file systems,
+	  // so stop trying for this file.  ENOSYS was handled by the
+	  // probe.  Anything else, such as EIO or EINTR, may be
+	  // transient and only makes us fall back for this call.
+	  if (bytes < 0
+	      && (errno == EXDEV || errno == EOPNOTSUPP || errno == EINVAL))
+	    this->copy_file_range_failed_ = true;
+
+	  // A failure part way through leaves the output partially
+	  // written; the caller will overwrite it by reading the
+	  // whole range.  A short input file is reported there.
+	  gold_debug(DEBUG_FILES, "copy_file_range from \"%s\" failed: %s",
+		     this->name_.c_str(),
+		     bytes < 0 ? strerror(errno) : "short copy");
+	  return false;
+	}
+      to_copy -= bytes;
+    }
+  return true;
+#else // !defined(HAVE_COPY_FILE_RANGE)
+  return false;
+#endif // !defined(HAVE_COPY_FILE_RANGE)
+}
+
 // Add a new view.  There may already be an existing view at this
 // offset.  If there is, the new view will be larger, and should
 // replace the old view.
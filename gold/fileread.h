@@ -72,7 +72,8 @@ class File_read
   File_read()
     : name_(), descriptor_(-1), is_descriptor_opened_(false), object_count_(0),
       size_(0), token_(false), views_(), saved_views_(), mapped_bytes_(0),
-      released_(true), whole_file_view_(NULL)
+      released_(true), whole_file_view_(NULL),
+      copy_file_range_failed_(false)
   { }
 
   ~File_read();
@@ -158,6 +159,16 @@ class File_read
   void
   read(off_t start, section_size_type size, void* p);
 
+  // Copy SIZE bytes starting at file offset START directly into the
+  // file descriptor O at offset OSTART, without passing the data
+  // through our address space.  This uses copy_file_range, which
+  // lets the kernel share the underlying blocks when the file system
+  // supports it.  Returns false if nothing was copied, in which case
+  // the caller should fall back to read.  The file must be locked.
+  bool
+  copy_to_descriptor(off_t start, section_size_type size, int o,
+		     off_t ostart);
+
   // Return a lasting view into the file starting at file offset START
   // for SIZE bytes.  This is allocated with new, and the caller is
   // responsible for deleting it when done.  The data associated with
@@ -442,6 +453,10 @@ class File_read
   // - The contents was specified in the constructor.  Used only for
   //   testing purposes).
   View* whole_file_view_;
+  // Whether copy_file_range has failed for this file in a way which
+  // will not change on retry, such as the input being on a different
+  // file system from the output.  Only used while the file is locked.
+  bool copy_file_range_failed_;
 };
 
 // A view of file data that persists even when the file is unlocked.
@@ -704,6 +704,11 @@ class General_options
 	      N_("Not supported"),
 	      N_("Do not copy DT_NEEDED tags from shared libraries"));
 
+  DEFINE_bool(copy_file_range, options::TWO_DASHES, '\0', true,
+	      N_("Copy unrelocated input sections with copy_file_range "
+		 "(default)"),
+	      N_("Always copy input sections through memory"));
+
   DEFINE_bool(cref, options::TWO_DASHES, '\0', false,
 	      N_("Output cross reference table"),
 	      N_("Do not output cross reference table"));
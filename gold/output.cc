@@ -5164,6 +5164,19 @@ Output_file::unmap()
   this->base_ = NULL;
 }
 
+// Copy data from an input file directly to the output file.
+
+bool
+Output_file::copy_from_input(File_read* file, off_t start, size_t size,
+			     off_t ostart)
+{
+  if (this->map_is_anonymous_ || this->base_ == NULL || this->o_ < 0)
+    return false;
+  gold_assert(ostart >= 0
+	      && ostart + static_cast<off_t>(size) <= this->file_size_);
+  return file->copy_to_descriptor(start, size, this->o_, ostart);
+}
+
 // Close the output file.
 
 void
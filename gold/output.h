@@ -34,6 +34,7 @@
 namespace gold
 {
 
+class File_read;
 class General_options;
 class Object;
 class Symbol;
@@ -4806,6 +4807,14 @@ class Output_file
   free_input_view(off_t, size_t, const unsigned char*)
   { }
 
+  // Copy SIZE bytes at offset START in the input file FILE to the
+  // output file at offset OSTART, bypassing the mapped view.  This
+  // only works when the output file itself is mapped, since
+  // otherwise the buffer would overwrite the copied data when the
+  // file is closed.  Returns false if the data was not copied.
+  bool
+  copy_from_input(File_read* file, off_t start, size_t size, off_t ostart);
+
  private:
   // Map the file into memory or, if that fails, allocate anonymous
   // memory.
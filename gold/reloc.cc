@@ -726,6 +726,31 @@ Sized_relobj_file<size, big_endian>::write_sections(const Layout* layout,
   File_read::Read_multiple rm;
   bool is_sorted = true;
 
+  // Large input sections which no relocation will touch may be
+  // copied to the output file by the kernel rather than read into
+  // the output view.  Find the sections that have relocations.
+  // Executable sections are excluded because some targets patch
+  // them while relocating (e.g., for erratum workarounds).
+  const section_size_type copy_file_range_min_size = 64 * 1024;
+  std::vector<bool> has_relocs;
+  bool use_copy_file_range = (parameters->options().copy_file_range()
+			      && !parameters->incremental());
+  if (use_copy_file_range)
+    {
+      has_relocs.resize(shnum, false);
+      const unsigned char* ps = pshdrs + This::shdr_size;
+      for (unsigned int i = 1; i < shnum; ++i, ps += This::shdr_size)
+	{
+	  typename This::Shdr shdr(ps);
+	  if (shdr.get_sh_type() != elfcpp::SHT_REL
+	      && shdr.get_sh_type() != elfcpp::SHT_RELA)
+	    continue;
+	  unsigned int index = this->adjust_shndx(shdr.get_sh_info());
+	  if (index < shnum)
+	    has_relocs[index] = true;
+	}
+    }
+
   const unsigned char* p = pshdrs + This::shdr_size;
   for (unsigned int i = 1; i < shnum; ++i, p += This::shdr_size)
     {
@@ -850,7 +875,17 @@ Sized_relobj_file<size, big_endian>::write_sections(const Layout* layout,
 	  else
 	    {
 	      view = of->get_output_view(view_start, view_size);
-	      if (!must_decompress)
+	      bool copied = false;
+	      if (!must_decompress
+		  && use_copy_file_range
+		  && view_size >= copy_file_range_min_size
+		  && !has_relocs[i]
+		  && (shdr.get_sh_flags() & elfcpp::SHF_EXECINSTR) == 0)
+		copied = of->copy_from_input(&this->input_file()->file(),
+					     (this->offset()
+					      + shdr.get_sh_offset()),
+					     view_size, view_start);
+	      if (!must_decompress && !copied)
 		{
 		  off_t sh_offset = shdr.get_sh_offset();
 		  if (!rm.empty() && rm.back().file_offset > sh_offset)
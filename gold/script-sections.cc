@@ -593,13 +593,11 @@ class Sections_element
   finalize_symbols(Symbol_table*, const Layout*, uint64_t*)
   { }
 
-  // Return the output section name to use for an input file name and
-  // section name.  This only real implementation is in
-  // Output_section_definition.
-  virtual const char*
-  output_section_name(const char*, const char*, Output_section***,
-		      Script_sections::Section_type*, bool*)
-  { return NULL; }
+  // Add the input section patterns of this element to MATCHER.  The
+  // only real implementation is in Output_section_definition.
+  virtual void
+  add_to_section_matcher(Input_section_matcher*)
+  { }
 
   // Initialize OSP with an output section.
   virtual void
@@ -819,6 +817,14 @@ class Output_section_element
   match_name(const char*, const char*, bool *) const
   { return false; }
 
+  // Add the input section patterns of this element, which is part of
+  // the output section OSD, to MATCHER.  The only real
+  // implementation is in Output_section_element_input.
+  virtual void
+  add_to_section_matcher(Input_section_matcher*,
+			 Output_section_definition*) const
+  { }
+
   // Set section addresses.  This includes applying assignments if the
   // expression is an absolute value.
   virtual void
@@ -1259,6 +1265,11 @@ class Output_section_element_input : public Output_section_element
   bool
   match_name(const char* file_name, const char* section_name, bool* keep) const;
 
+  // Add our input section patterns to MATCHER.
+  void
+  add_to_section_matcher(Input_section_matcher* matcher,
+			 Output_section_definition* osd) const;
+
   // Set the section address.
   void
   set_section_addresses(Symbol_table* symtab, Layout* layout, Output_section*,
@@ -1440,6 +1451,185 @@ Output_section_element_input::match_name(const char* file_name,
   return false;
 }
 
+// Input_section_matcher is used to quickly find the elements of a
+// SECTIONS clause which may match an input section name.  The
+// section name patterns of all the input section specs are compiled
+// once: names without wildcards go into a hash table, patterns which
+// are a fixed prefix followed by a single '*' are looked up by
+// prefix, and only the remaining patterns are matched with fnmatch.
+// The list of candidate elements for each section name is cached, so
+// for each input section we only need to check the file name
+// patterns of the candidates, in script order.
+
+class Input_section_matcher
+{
+ public:
+  typedef std::vector<unsigned int> Indexes;
+
+  Input_section_matcher()
+    : entries_(), exact_(), prefixes_(), prefix_lengths_(), wildcards_(),
+      match_all_(), candidates_()
+  { }
+
+  // Add the input section element INPUT, which is part of the output
+  // section OSD.  Elements must be added in script order.  Return
+  // the index of the element.
+  unsigned int
+  add_element(Output_section_definition* osd,
+	      const Output_section_element_input* input)
+  {
+    this->entries_.push_back(Entry(osd, input));
+    return this->entries_.size() - 1;
+  }
+
+  // Record that element INDEX matches all section names.
+  void
+  add_match_all(unsigned int index)
+  { this->match_all_.push_back(index); }
+
+  // Record that element INDEX has the section name pattern PATTERN.
+  void
+  add_pattern(unsigned int index, const std::string& pattern,
+	      bool is_wildcard);
+
+  // Return the indexes of the elements which may match SECTION_NAME,
+  // in script order.
+  const Indexes&
+  candidates(const char* section_name);
+
+  // Return the output section of element INDEX.
+  Output_section_definition*
+  output_section_definition(unsigned int index) const
+  { return this->entries_[index].osd; }
+
+  // Return element INDEX.
+  const Output_section_element_input*
+  input_element(unsigned int index) const
+  { return this->entries_[index].input; }
+
+ private:
+  // An input section element and the output section it belongs to.
+  struct Entry
+  {
+    Output_section_definition* osd;
+    const Output_section_element_input* input;
+
+    Entry(Output_section_definition* osda,
+	  const Output_section_element_input* inputa)
+      : osd(osda), input(inputa)
+    { }
+  };
+
+  typedef Unordered_map<std::string, Indexes> Name_indexes;
+  typedef std::vector<std::pair<std::string, unsigned int> > Wildcards;
+
+  // All the input section elements, in script order.
+  std::vector<Entry> entries_;
+  // Elements indexed by section names which are not wildcards.
+  Name_indexes exact_;
+  // Elements indexed by the prefix of a "prefix*" pattern.
+  Name_indexes prefixes_;
+  // The distinct lengths of the keys in prefixes_, sorted.
+  std::vector<size_t> prefix_lengths_;
+  // All other patterns, which need fnmatch.
+  Wildcards wildcards_;
+  // Elements with no section name patterns.
+  Indexes match_all_;
+  // Cache of the result of candidates.
+  Name_indexes candidates_;
+};
+
+// Record a section name pattern.
+
+void
+Input_section_matcher::add_pattern(unsigned int index,
+				   const std::string& pattern,
+				   bool is_wildcard)
+{
+  if (!is_wildcard)
+    {
+      this->exact_[pattern].push_back(index);
+      return;
+    }
+
+  // A pattern like ".text.*" is a simple prefix match.  Backslash
+  // quotes the next character for fnmatch, so we leave those alone.
+  size_t len = pattern.length();
+  if (pattern.find_first_of("?*[\\") == len - 1 && pattern[len - 1] == '*')
+    {
+      this->prefixes_[pattern.substr(0, len - 1)].push_back(index);
+      std::vector<size_t>::iterator p =
+	std::lower_bound(this->prefix_lengths_.begin(),
+			 this->prefix_lengths_.end(), len - 1);
+      if (p == this->prefix_lengths_.end() || *p != len - 1)
+	this->prefix_lengths_.insert(p, len - 1);
+      return;
+    }
+
+  this->wildcards_.push_back(std::make_pair(pattern, index));
+}
+
+// Return the elements which may match SECTION_NAME.
+
+const Input_section_matcher::Indexes&
+Input_section_matcher::candidates(const char* section_name)
+{
+  std::string name(section_name);
+  Name_indexes::const_iterator p = this->candidates_.find(name);
+  if (p != this->candidates_.end())
+    return p->second;
+
+  Indexes result(this->match_all_);
+
+  p = this->exact_.find(name);
+  if (p != this->exact_.end())
+    result.insert(result.end(), p->second.begin(), p->second.end());
+
+  for (std::vector<size_t>::const_iterator pl = this->prefix_lengths_.begin();
+       pl != this->prefix_lengths_.end() && *pl <= name.length();
+       ++pl)
+    {
+      p = this->prefixes_.find(name.substr(0, *pl));
+      if (p != this->prefixes_.end())
+	result.insert(result.end(), p->second.begin(), p->second.end());
+    }
+
+  for (Wildcards::const_iterator pw = this->wildcards_.begin();
+       pw != this->wildcards_.end();
+       ++pw)
+    {
+      if (fnmatch(pw->first.c_str(), section_name, 0) == 0)
+	result.push_back(pw->second);
+    }
+
+  std::sort(result.begin(), result.end());
+  result.erase(std::unique(result.begin(), result.end()), result.end());
+
+  return this->candidates_.insert(std::make_pair(name, result)).first->second;
+}
+
+// Add our input section patterns to MATCHER.
+
+void
+Output_section_element_input::add_to_section_matcher(
+    Input_section_matcher* matcher,
+    Output_section_definition* osd) const
+{
+  unsigned int index = matcher->add_element(osd, this);
+
+  if (this->input_section_patterns_.empty())
+    {
+      matcher->add_match_all(index);
+      return;
+    }
+
+  for (Input_section_patterns::const_iterator p =
+	 this->input_section_patterns_.begin();
+       p != this->input_section_patterns_.end();
+       ++p)
+    matcher->add_pattern(index, p->pattern, p->pattern_is_wildcard);
+}
+
 // Information we use to sort the input sections.
 
 class Input_section_info
@@ -1908,12 +2098,16 @@ class Output_section_definition : public Sections_element
   void
   finalize_symbols(Symbol_table*, const Layout*, uint64_t*);
 
-  // Return the output section name to use for an input file name and
-  // section name.
+  // Add the input section patterns of our elements to MATCHER.
+  void
+  add_to_section_matcher(Input_section_matcher* matcher);
+
+  // Return the output section name to use for an input section which
+  // matched one of our elements.  Set *SLOT to point to where the
+  // output section is stored and *PSECTION_TYPE to the section type.
   const char*
-  output_section_name(const char* file_name, const char* section_name,
-		      Output_section***, Script_sections::Section_type*,
-		      bool*);
+  output_section_name(Output_section*** slot,
+		      Script_sections::Section_type* psection_type);
 
   // Initialize OSP with an output section.
   void
@@ -2191,33 +2385,29 @@ Output_section_definition::finalize_symbols(Symbol_table* symtab,
     (*p)->finalize_symbols(symtab, layout, dot_value, &dot_section);
 }
 
-// Return the output section name to use for an input section name.
+// Add the input section patterns of our elements to MATCHER.
 
-const char*
-Output_section_definition::output_section_name(
-    const char* file_name,
-    const char* section_name,
-    Output_section*** slot,
-    Script_sections::Section_type* psection_type,
-    bool* keep)
+void
+Output_section_definition::add_to_section_matcher(
+    Input_section_matcher* matcher)
 {
-  // Ask each element whether it matches NAME.
   for (Output_section_elements::const_iterator p = this->elements_.begin();
        p != this->elements_.end();
        ++p)
-    {
-      if ((*p)->match_name(file_name, section_name, keep))
-	{
-	  // We found a match for NAME, which means that it should go
-	  // into this output section.
-	  *slot = &this->output_section_;
-	  *psection_type = this->section_type();
-	  return this->name_.c_str();
-	}
-    }
+    (*p)->add_to_section_matcher(matcher, this);
+}
 
-  // We don't know about this section name.
-  return NULL;
+// Return the output section name to use for an input section which
+// matched one of our elements.
+
+const char*
+Output_section_definition::output_section_name(
+    Output_section*** slot,
+    Script_sections::Section_type* psection_type)
+{
+  *slot = &this->output_section_;
+  *psection_type = this->section_type();
+  return this->name_.c_str();
 }
 
 // Return true if memory from START to START + LENGTH is contained
@@ -3227,6 +3417,7 @@ Script_sections::Script_sections()
     memory_regions_(NULL),
     phdrs_elements_(NULL),
     orphan_section_placement_(NULL),
+    section_matcher_(NULL),
     data_segment_align_start_(),
     saw_data_segment_align_(false),
     saw_relro_end_(false),
@@ -3328,6 +3519,7 @@ Script_sections::start_output_section(
   this->sections_elements_->push_back(posd);
   gold_assert(this->output_section_ == NULL);
   this->output_section_ = posd;
+  this->clear_section_matcher();
 }
 
 // Stop processing entries for an output section.
@@ -3339,6 +3531,7 @@ Script_sections::finish_output_section(
   gold_assert(this->output_section_ != NULL);
   this->output_section_->finish(trailer);
   this->output_section_ = NULL;
+  this->clear_section_matcher();
 }
 
 // Add a data item to the current output section.
@@ -3444,6 +3637,37 @@ Script_sections::finalize_symbols(Symbol_table* symtab, const Layout* layout)
     (*p)->finalize_symbols(symtab, layout, &dot_value);
 }
 
+// Return the matcher for input section names, building it from the
+// SECTIONS clause if necessary.
+
+Input_section_matcher*
+Script_sections::section_matcher()
+{
+  if (this->section_matcher_ == NULL)
+    {
+      Input_section_matcher* matcher = new Input_section_matcher();
+      for (Sections_elements::const_iterator p =
+	     this->sections_elements_->begin();
+	   p != this->sections_elements_->end();
+	   ++p)
+	(*p)->add_to_section_matcher(matcher);
+      this->section_matcher_ = matcher;
+    }
+  return this->section_matcher_;
+}
+
+// Discard the matcher for input section names.
+
+void
+Script_sections::clear_section_matcher()
+{
+  if (this->section_matcher_ != NULL)
+    {
+      delete this->section_matcher_;
+      this->section_matcher_ = NULL;
+    }
+}
+
 // Return the name of the output section to use for an input file name
 // and section name.
 
@@ -3455,16 +3679,23 @@ Script_sections::output_section_name(
     Script_sections::Section_type* psection_type,
     bool* keep)
 {
-  for (Sections_elements::const_iterator p = this->sections_elements_->begin();
-       p != this->sections_elements_->end();
+  // The first input section element in the script which matches
+  // both the file name and the section name wins.  The matcher gives
+  // us the elements whose section name patterns match, so we only
+  // need to check the file names.
+  Input_section_matcher* matcher = this->section_matcher();
+  const Input_section_matcher::Indexes& candidates =
+    matcher->candidates(section_name);
+  for (Input_section_matcher::Indexes::const_iterator p = candidates.begin();
+       p != candidates.end();
        ++p)
     {
-      const char* ret = (*p)->output_section_name(file_name, section_name,
-						  output_section_slot,
-						  psection_type, keep);
-
-      if (ret != NULL)
+      if (matcher->input_element(*p)->match_name(file_name, section_name,
+						 keep))
 	{
+	  const char* ret = matcher->output_section_definition(*p)->
+	    output_section_name(output_section_slot, psection_type);
+
 	  // The special name /DISCARD/ means that the input section
 	  // should be discarded.
 	  if (strcmp(ret, "/DISCARD/") == 0)
@@ -36,6 +36,7 @@ struct Parser_output_section_header;
 struct Parser_output_section_trailer;
 struct Input_section_spec;
 class Expression;
+class Input_section_matcher;
 class Sections_element;
 class Memory_region;
 class Phdrs_element;
@@ -296,6 +297,16 @@ class Script_sections
   Output_segment*
   set_phdrs_clause_addresses(Layout*, uint64_t);
 
+  // Return the matcher for input section names, building it if
+  // necessary.
+  Input_section_matcher*
+  section_matcher();
+
+  // Discard the matcher for input section names, because the
+  // SECTIONS clause has changed.
+  void
+  clear_section_matcher();
+
   // True if we ever saw a SECTIONS clause.
   bool saw_sections_clause_;
   // True if we are currently processing a SECTIONS clause.
@@ -310,6 +321,9 @@ class Script_sections
   Phdrs_elements* phdrs_elements_;
   // Where to put orphan sections.
   Orphan_section_placement* orphan_section_placement_;
+  // The compiled input section patterns, built the first time we
+  // look up an input section.  This may be NULL.
+  Input_section_matcher* section_matcher_;
   // A pointer to the last Sections_element when we see
   // DATA_SEGMENT_ALIGN.
   Sections_elements::iterator data_segment_align_start_;